@@ -3,6 +3,12 @@
 set -xe
 
 OUT="cw_tree.out"
+SRC="src/node.cpp src/format.cpp src/continued.cpp src/stern_brocot.cpp \
+     src/label.cpp src/recent.cpp src/gaps.cpp src/farey.cpp src/state.cpp \
+     src/worker.cpp src/draw.cpp src/options.cpp src/index.cpp \
+     src/snapshot.cpp src/headless.cpp src/query.cpp src/checkpoint.cpp \
+     src/compact.cpp src/journal.cpp src/serialise.cpp src/exporter.cpp \
+     src/main.cpp"
 GFLAGS="-Wall -Wextra -Wswitch-enum -std=c++17 -Iraylib-5.5_linux_amd64/include"
 LIBS="-Lraylib-5.5_linux_amd64/lib -l:libraylib.a" # link statically with raylib
 VARFLAGS="-DTHREAD_PAUSE_MS=1000 -DTHREAD_GENERAL_MS=1"
@@ -19,8 +25,15 @@ then
     shift 1
 fi
 
-c++ $CFLAGS -o $OUT src/node.cpp src/state.cpp src/worker.cpp src/main.cpp $LIBS
+c++ $CFLAGS -o $OUT $SRC $LIBS
 if [ "$1" = "run" ]
 then
     ./$OUT
 fi
+if [ "$1" = "test" ]
+then
+    sh tests/query.sh ./$OUT
+    sh tests/compact.sh ./$OUT
+    c++ $CFLAGS -Isrc -o tests/index.out tests/index.cpp src/index.cpp
+    ./tests/index.out
+fi
@@ -0,0 +1,371 @@
+/* checkpoint.cpp: Saving generation to disk and picking it back up
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checkpoint.hpp"
+#include "checksum.hpp"
+#include "compact.hpp"
+#include "parallel.hpp"
+#include "radix.hpp"
+
+namespace cw::checkpoint
+{
+  using cw::node::Node;
+  using cw::state::State;
+
+  static_assert(std::is_trivially_copyable<Node>::value,
+                "Nodes are written and mapped back in as raw bytes");
+
+  // Nodes copied out at a time when reindexing.
+  constexpr u64 CHUNK = 1 << 12;
+
+  static u64 align_up(u64 x, u64 alignment)
+  {
+    return (x + alignment - 1) / alignment * alignment;
+  }
+
+  static bool write_at(int fd, const void *buffer, u64 size, u64 offset)
+  {
+    const u8 *bytes = static_cast<const u8 *>(buffer);
+    while (size > 0)
+    {
+      ssize_t put = pwrite(fd, bytes, size, offset);
+      if (put < 0 && errno == EINTR)
+        continue;
+      if (put <= 0)
+        return false;
+      bytes += put;
+      size -= put;
+      offset += put;
+    }
+    return true;
+  }
+
+  static u64 shard_checksum(const Node *nodes, const Shard &shard)
+  {
+    return cw::checksum::bytes(nodes, shard.count * sizeof(Node),
+                               shard.first);
+  }
+
+  bool save(const State &state, const char *path)
+  {
+    const cw::node::NodeAllocator &allocator = state.allocator;
+
+    cw::state::DrawState draw_state;
+    draw_state.compute_bounds(allocator.size());
+    const cw::node::Fraction &lower = draw_state.bounds.leftmost.value,
+                             &upper = draw_state.bounds.rightmost.value;
+
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.endian        = ENDIAN_TAG;
+    header.version       = VERSION;
+    header.node_size     = sizeof(Node);
+    header.nodes         = allocator.size();
+    header.nodes_offset  = align_up(sizeof(Header), CHECKPOINT_ALIGN);
+    header.lower[0]      = lower.numerator;
+    header.lower[1]      = lower.denominator;
+    header.upper[0]      = upper.numerator;
+    header.upper[1]      = upper.denominator;
+    header.shards = (header.nodes + CHECKPOINT_SHARD - 1) / CHECKPOINT_SHARD;
+    header.shards_offset = header.nodes_offset + (header.nodes * sizeof(Node));
+
+    const u64 size = header.shards_offset + (header.shards * sizeof(Shard));
+
+    std::string temporary = std::string{path} + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+      fprintf(stderr, "checkpoint: can't write `%s`: %s\n", temporary.c_str(),
+              strerror(errno));
+      return false;
+    }
+
+    // Sized up front, so shards can land anywhere in it in any order; the
+    // padding after the header is left as the hole this makes.
+    std::atomic<int> error{ftruncate(fd, size) == 0 ? 0 : errno};
+    std::vector<Shard> shards(header.shards);
+    std::atomic<u64> next{0};
+    cw::parallel::for_chunks(
+        error == 0 ? MIN(cw::parallel::n_threads(), header.shards) : 0,
+        [&](u64) {
+          std::vector<Node> buffer;
+          for (u64 s = next++; s < shards.size() && error == 0; s = next++)
+          {
+            Shard &shard = shards[s];
+            shard.first  = s * CHECKPOINT_SHARD;
+            shard.count  = MIN(header.nodes - shard.first, CHECKPOINT_SHARD);
+            shard.offset = header.nodes_offset + (shard.first * sizeof(Node));
+            buffer.resize(shard.count);
+            for (u64 i = 0; i < shard.count; ++i)
+              buffer[i] = allocator.get_val(shard.first + i);
+            shard.checksum = shard_checksum(buffer.data(), shard);
+            if (!write_at(fd, buffer.data(), shard.count * sizeof(Node),
+                          shard.offset))
+              error = errno;
+          }
+        });
+
+    bool ok = error == 0 &&
+              write_at(fd, &header, sizeof(header), 0) &&
+              write_at(fd, shards.data(), shards.size() * sizeof(Shard),
+                       header.shards_offset);
+    if (error != 0)
+      errno = error;
+    // Make sure it's all on disk before it replaces the last checkpoint.
+    ok = ok && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    ok = ok && rename(temporary.c_str(), path) == 0;
+    if (!ok)
+    {
+      fprintf(stderr, "checkpoint: failed writing `%s`: %s\n", path,
+              strerror(errno));
+      unlink(temporary.c_str());
+    }
+    return ok;
+  }
+
+  // Why the checkpoint in `map` (of `size` bytes) is no good, or nullptr.
+  static const char *validate(const u8 *map, u64 size)
+  {
+    if (size < sizeof(Header))
+      return "too short for a header";
+    const Header &header = *reinterpret_cast<const Header *>(map);
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+      return "not a checkpoint";
+    if (header.endian != ENDIAN_TAG)
+      return "written with the other byte order";
+    if (header.version != VERSION)
+      return "written by a different version";
+    if (header.node_size != sizeof(Node))
+      return "written with a different node layout";
+    if (header.nodes == 0)
+      return "no nodes";
+    if (header.nodes_offset % alignof(Node) != 0 ||
+        header.shards_offset % alignof(Shard) != 0)
+      return "misaligned";
+    if (header.nodes_offset > size ||
+        header.nodes > (size - header.nodes_offset) / sizeof(Node) ||
+        header.shards_offset > size ||
+        header.shards > (size - header.shards_offset) / sizeof(Shard))
+      return "truncated";
+
+    // The shards must cover the nodes, in order, each where it should be.
+    const Shard *shards =
+        reinterpret_cast<const Shard *>(map + header.shards_offset);
+    u64 covered = 0;
+    for (u64 s = 0; s < header.shards; ++s)
+    {
+      if (shards[s].first != covered ||
+          shards[s].count > header.nodes - covered ||
+          shards[s].offset !=
+              header.nodes_offset + (shards[s].first * sizeof(Node)))
+        return "shard index doesn't match the nodes";
+      covered += shards[s].count;
+    }
+    if (covered != header.nodes)
+      return "shard index doesn't match the nodes";
+    return nullptr;
+  }
+
+  // Why the nodes of `shard` are no good, or nullptr: they must match its
+  // checksum, and each node's links must be the ones the count implies.
+  static const char *verify_shard(const Node *nodes, const Shard &shard,
+                                  u64 count)
+  {
+    if (shard_checksum(nodes, shard) != shard.checksum)
+      return "checksum mismatch";
+    for (u64 i = 0; i < shard.count; ++i)
+      if (nodes[i].left != cw::state::implied_left(shard.first + i, count) ||
+          nodes[i].right != cw::state::implied_right(shard.first + i, count))
+        return "links out of place";
+    return nullptr;
+  }
+
+  // The first shard in `map` that fails verify_shard, with why in
+  // `problem`, or nullptr.  Shards are handed out to a thread per core as
+  // they finish.
+  static const Shard *verify_shards(const u8 *map, const char *&problem)
+  {
+    const Header &header = *reinterpret_cast<const Header *>(map);
+    const Shard *shards =
+        reinterpret_cast<const Shard *>(map + header.shards_offset);
+    std::vector<const char *> problems(header.shards, nullptr);
+    std::atomic<u64> next{0}, bad{header.shards};
+    cw::parallel::for_chunks(
+        MIN(cw::parallel::n_threads(), header.shards), [&](u64) {
+          for (u64 s = next++; s < header.shards && bad == header.shards;
+               s = next++)
+          {
+            const Node *nodes =
+                reinterpret_cast<const Node *>(map + shards[s].offset);
+            problems[s] = verify_shard(nodes, shards[s], header.nodes);
+            if (problems[s])
+              bad = s;
+          }
+        });
+    if (bad == header.shards)
+      return nullptr;
+    problem = problems[bad];
+    return shards + bad;
+  }
+
+  Restore restore(State &state, const char *path, bool verify)
+  {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 && errno == ENOENT)
+      return Restore::MISSING;
+
+    char magic[sizeof(MAGIC)];
+    if (fd >= 0 && pread(fd, magic, sizeof(magic), 0) == sizeof(magic) &&
+        memcmp(magic, cw::compact::MAGIC, sizeof(magic)) == 0)
+    {
+      close(fd);
+      return cw::compact::restore(state, path);
+    }
+
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+      fprintf(stderr, "checkpoint: can't read `%s`: %s\n", path,
+              strerror(errno));
+      if (fd >= 0)
+        close(fd);
+      return Restore::FAILED;
+    }
+
+    // Private and writable: children get linked into frontier nodes in
+    // place, in pages of our own, rather than in the file.
+    const u64 size = info.st_size;
+    void *map      = size == 0 ? MAP_FAILED
+                               : mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                      MAP_PRIVATE, fd, 0);
+    close(fd);
+    const char *problem = map == MAP_FAILED
+                              ? "can't be mapped"
+                              : validate(static_cast<const u8 *>(map), size);
+    if (problem)
+    {
+      fprintf(stderr, "checkpoint: `%s`: %s\n", path, problem);
+      if (map != MAP_FAILED)
+        munmap(map, size);
+      return Restore::FAILED;
+    }
+
+    u8 *bytes            = static_cast<u8 *>(map);
+    const Header &header = *reinterpret_cast<const Header *>(bytes);
+    if (const Shard *bad = verify ? verify_shards(bytes, problem) : nullptr)
+    {
+      fprintf(stderr, "checkpoint: `%s`: %s in nodes [%lu, %lu)\n", path,
+              problem, bad->first, bad->first + bad->count);
+      munmap(map, size);
+      return Restore::FAILED;
+    }
+
+    std::shared_ptr<void> owner{map, [size](void *p) { munmap(p, size); }};
+    Node *nodes = reinterpret_cast<Node *>(bytes + header.nodes_offset);
+    state.allocator.adopt(nodes, header.nodes, std::move(owner));
+    return Restore::RESTORED;
+  }
+
+  u64 replay(State &state, cw::index::Run &&journalled)
+  {
+    cw::index::Run scratch(journalled.size());
+    cw::radix::sort(journalled.data(), scratch.data(), journalled.size(),
+                    [](const cw::index::Entry &e) { return e.index(); });
+
+    // Both children of a node are generated together, so the nodes that
+    // follow on come in pairs, each the children of the node at the front
+    // of the queue.  Duplicates (journalled again after a replay which had
+    // to stop short of them) sort next to each other.
+    const u64 start = state.allocator.size();
+    if (start % 2 == 0) // a node short of its sibling: not ours to finish
+      return 0;
+    u64 end = start;
+    for (const cw::index::Entry &entry : journalled)
+      if (entry.index() == end)
+        ++end;
+      else if (entry.index() > end)
+        break;
+    end = start + ((end - start) & ~1ULL);
+
+    u64 i = start;
+    for (const cw::index::Entry &entry : journalled)
+    {
+      if (i == end)
+        break;
+      if (entry.index() != i)
+        continue;
+      if (i % 2 == 1)
+      {
+        Node &node = state.allocator.get_ref(cw::state::next_parent(i));
+        node.left  = i;
+        node.right = i + 1;
+      }
+      state.allocator.alloc(
+          Node{cw::node::Fraction{entry.numerator, entry.denominator}});
+      ++i;
+    }
+    return i - start;
+  }
+
+  void reindex(State &state, u64 count)
+  {
+    cw::index::Run batch;
+    std::vector<Node> chunk;
+    // An export has to have every node to be any use, so that isn't cut
+    // short.
+    const bool exporting = state.exporter.active();
+    for (u64 begin = 0; begin < count && (exporting || !state.stop_work);
+         begin += CHUNK)
+    {
+      const u64 end = MIN(count, begin + CHUNK);
+      chunk.clear();
+      state.mutex.lock();
+      for (u64 i = begin; i < end; ++i)
+        chunk.push_back(state.allocator.get_val(i));
+      state.mutex.unlock();
+
+      batch.clear();
+      for (u64 i = begin; i < end; ++i)
+      {
+        const cw::node::Fraction &value = chunk[i - begin].value;
+        batch.push_back({value.numerator, value.denominator,
+                         cw::node::key_of_index(i)});
+        state.farey.record(value.numerator, value.denominator, i);
+      }
+      state.exporter.append(batch.data(), batch.size());
+      state.gaps.insert(batch.data(), batch.size());
+      state.index.insert(std::move(batch));
+    }
+  }
+} // namespace cw::checkpoint
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
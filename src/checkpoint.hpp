@@ -0,0 +1,123 @@
+/* checkpoint.hpp: Saving generation to disk and picking it back up
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include "base.hpp"
+#include "state.hpp"
+
+namespace cw::checkpoint
+{
+  // A checkpoint is the allocator's nodes exactly as they sit in memory,
+  // behind a fixed header, with an index of shards at the end:
+  //
+  //   Header | padding to CHECKPOINT_ALIGN | Node[nodes] | Shard[shards]
+  //
+  // The work queue isn't stored: it's always the last nodes, as many as
+  // the count says (see cw::state::State).
+  //
+  // Nodes are written raw, so the file is only good on a host with the same
+  // byte order and Node layout; the header records both and restore refuses
+  // anything else.  Bump VERSION whenever the layout changes.
+  //
+  // Every node's offset is known before any are written, so the nodes are
+  // split into shards of CHECKPOINT_SHARD which threads copy out and write
+  // at once, each to its own place in the file.  The index gives each
+  // shard's place and a checksum over it, so they can be checked in
+  // parallel on the way back in too.
+  constexpr u32 VERSION    = 3;
+  constexpr u32 ENDIAN_TAG = 0x01020304; // reads back as 0x04030201 if swapped
+  constexpr char MAGIC[8]  = {'C', 'W', 'T', 'R', 'E', 'E', 'C', 'K'};
+
+#ifndef CHECKPOINT_ALIGN
+#define CHECKPOINT_ALIGN 4096
+#endif
+
+#ifndef CHECKPOINT_SHARD
+#define CHECKPOINT_SHARD (1 << 20)
+#endif
+
+  struct Header
+  {
+    char magic[8];
+    u32 endian, version;
+    u32 node_size, reserved; // sizeof(Node) of the writer
+    u64 nodes;
+    u64 nodes_offset; // in bytes from the start
+    // Ends of the number line for `nodes` nodes (numerator, denominator),
+    // for anything looking at the file without walking the nodes.
+    u64 lower[2], upper[2];
+    u64 shards, shards_offset;
+  };
+
+  struct Shard
+  {
+    u64 first, count; // nodes [first, first + count)
+    u64 offset;       // of node `first` in bytes from the start
+    u64 checksum;     // cw::checksum::bytes of the nodes, seeded with first
+  };
+
+  // Write every node to `path`, by way of a temporary
+  // file renamed over it, so a crash part way through leaves the last
+  // checkpoint as it was.  Shards are written by a thread each, up to one
+  // per core.  Generation must be stopped.  Prints why and returns false on
+  // failure.
+  bool save(const cw::state::State &, const char *path);
+
+  enum class Restore
+  {
+    MISSING,  // no checkpoint there: start from scratch
+    RESTORED, // state now carries on from the checkpoint
+    FAILED,   // there's something there, but not a checkpoint we can use
+  };
+
+  // Map the checkpoint at `path` straight in as the allocator's nodes, with
+  // no parsing or copying: pages are read in as they're touched, and copied
+  // on write when a frontier node gets its children, so the file itself is
+  // never modified.  Only the header and shard index are checked, so this
+  // costs the same however many nodes there are.  `state` must be fresh.
+  // The other structures fed from the nodes (index, gaps, Farey coverage)
+  // are left empty for reindex().  Compact checkpoints (see compact.hpp)
+  // are handed over to cw::compact::restore.  With `verify`, every shard is
+  // read and checked against its checksum, and every node's links against
+  // where the count puts them, first, a thread per core, which costs a pass
+  // over the file but also leaves it in the page cache.  Prints why on
+  // FAILED.
+  Restore restore(cw::state::State &, const char *path, bool verify);
+
+  // Carry on generation through `journalled` (nodes in any order, as read
+  // back from a journal) where it picks up from the current state, as far
+  // as the nodes follow on from it without a gap.  Anything after a gap was
+  // lost in a crash along with the nodes before it, and is left to be
+  // generated again.  Returns the number of nodes added.
+  u64 replay(cw::state::State &, cw::index::Run &&journalled);
+
+  // Feed the first `count` nodes into everything else in state that's fed
+  // from them (but the journal, which has them already or has no need), as
+  // the workers would have when generating them.  Safe to run alongside the
+  // workers, which is how main uses it: generation carries on at once while
+  // this catches up.  That includes the export, so it gets the root and
+  // anything restored too.  Gives up early on stop_work, unless there's an
+  // export to finish.
+  void reindex(cw::state::State &, u64 count);
+} // namespace cw::checkpoint
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,64 @@
+/* checksum.hpp: Cheap checksums for catching torn or corrupted blocks
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef CHECKSUM_HPP
+#define CHECKSUM_HPP
+
+#include <cstring>
+
+#include "base.hpp"
+
+namespace cw::checksum
+{
+  // splitmix64's finaliser: every bit of the input affects every bit out.
+  inline u64 mix(u64 x)
+  {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  // Checksum of bytes[0, size), a word at a time (the last zero padded), each
+  // mixed into the sum so far: reordered words change it as well as flipped
+  // bits.  Not meant to stand up to anyone forging blocks, only to crashes
+  // and bad disks.
+  inline u64 bytes(const void *data, u64 size, u64 seed)
+  {
+    const u8 *p = static_cast<const u8 *>(data);
+    u64 sum     = mix(seed ^ size);
+    for (; size >= sizeof(u64); p += sizeof(u64), size -= sizeof(u64))
+    {
+      u64 word;
+      memcpy(&word, p, sizeof(word));
+      sum = mix(sum ^ word);
+    }
+    if (size > 0)
+    {
+      u64 word = 0;
+      memcpy(&word, p, size);
+      sum = mix(sum ^ word);
+    }
+    return sum;
+  }
+} // namespace cw::checksum
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
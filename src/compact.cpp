@@ -0,0 +1,396 @@
+/* compact.cpp: Checkpoints which only store what the count doesn't say
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "checksum.hpp"
+#include "compact.hpp"
+#include "parallel.hpp"
+#include "serialise.hpp"
+
+namespace cw::compact
+{
+  using cw::checkpoint::Restore;
+  using cw::node::Fraction;
+  using cw::node::Node;
+  using cw::node::NodeAllocator;
+  using cw::state::implied_left;
+  using cw::state::implied_right;
+  using cw::state::State;
+
+  static void put_varint(std::vector<u8> &out, u64 x)
+  {
+    while (x >= 0x80)
+    {
+      out.push_back(static_cast<u8>(x | 0x80));
+      x >>= 7;
+    }
+    out.push_back(static_cast<u8>(x));
+  }
+
+  // Small differences either way as small unsigned numbers.
+  static u64 zigzag(i64 x)
+  {
+    return (static_cast<u64>(x) << 1) ^ static_cast<u64>(x >> 63);
+  }
+
+  static i64 unzigzag(u64 x)
+  {
+    return static_cast<i64>(x >> 1) ^ -static_cast<i64>(x & 1);
+  }
+
+  struct Exception
+  {
+    u64 index, flags;
+    Node node;
+  };
+
+  // Every node which isn't as the count implies, in index order.
+  static std::vector<Exception> find_exceptions(const NodeAllocator &allocator)
+  {
+    const u64 count = allocator.size();
+    std::mutex mutex;
+    std::vector<std::pair<u64, std::vector<Exception>>> chunks;
+    parallel::for_range(0, count, [&](u64 begin, u64 end) {
+      std::vector<Exception> found;
+      Fraction implied = cw::node::unrank(begin);
+      for (u64 i = begin; i < end; ++i)
+      {
+        Node node = allocator.get_val(i);
+        u64 flags = 0;
+        if (node.value.numerator != implied.numerator ||
+            node.value.denominator != implied.denominator)
+          flags |= VALUE;
+        if (node.left != implied_left(i, count))
+          flags |= LEFT;
+        if (node.right != implied_right(i, count))
+          flags |= RIGHT;
+        if (flags != 0)
+          found.push_back(Exception{i, flags, node});
+        if (i + 1 < end)
+          implied = cw::node::next(implied);
+      }
+      std::lock_guard<std::mutex> lock{mutex};
+      chunks.emplace_back(begin, std::move(found));
+    });
+
+    std::sort(chunks.begin(), chunks.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+    std::vector<Exception> exceptions;
+    for (auto &chunk : chunks)
+      exceptions.insert(exceptions.end(), chunk.second.begin(),
+                        chunk.second.end());
+    return exceptions;
+  }
+
+  static u64 block_checksum(const BlockHeader &header, const u8 *records)
+  {
+    u64 seed = (static_cast<u64>(header.section) << 32) | header.records;
+    return cw::checksum::bytes(records, header.bytes, seed);
+  }
+
+  // Gathers records into blocks of up to COMPACT_BLOCK_RECORDS and writes
+  // each one out as it fills.
+  struct BlockWriter
+  {
+    cw::serialise::Writer &out;
+    Section section;
+    std::vector<u8> records;
+    u64 in_block = 0, blocks = 0;
+
+    // The first record of each block has nothing to differ from.
+    bool starts_block(void) const
+    {
+      return in_block == 0;
+    }
+
+    void end_record(void)
+    {
+      if (++in_block == COMPACT_BLOCK_RECORDS)
+        finish();
+    }
+
+    void finish(void)
+    {
+      if (in_block == 0)
+        return;
+      BlockHeader header{BLOCK_MAGIC, section, static_cast<u32>(in_block),
+                         static_cast<u32>(records.size()), 0};
+      header.checksum = block_checksum(header, records.data());
+      out.put_bytes(&header, sizeof(header));
+      out.put_bytes(records.data(), records.size());
+      records.clear();
+      in_block = 0;
+      ++blocks;
+    }
+  };
+
+  bool save(const State &state, const char *path)
+  {
+    const NodeAllocator &allocator = state.allocator;
+    const u64 count                = allocator.size();
+    std::vector<Exception> exceptions = find_exceptions(allocator);
+
+    std::string temporary = std::string{path} + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+      fprintf(stderr, "checkpoint: can't write `%s`: %s\n", temporary.c_str(),
+              strerror(errno));
+      return false;
+    }
+
+    // Blocks are counted as they go, so the header goes in last.
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.endian     = cw::checkpoint::ENDIAN_TAG;
+    header.version    = VERSION;
+    header.nodes      = count;
+    header.exceptions = exceptions.size();
+    header.frontier   = ~0ULL;
+
+    bool ok;
+    {
+      cw::serialise::Writer out{fd};
+      out.put_bytes(&header, sizeof(header));
+
+      BlockWriter nodes{out, Section::NODES, {}};
+      u64 last = 0;
+      for (const Exception &e : exceptions)
+      {
+        std::vector<u8> &r = nodes.records;
+        put_varint(r, nodes.starts_block() ? e.index : e.index - last);
+        put_varint(r, e.flags);
+        if (e.flags & VALUE)
+        {
+          put_varint(r, e.node.value.numerator);
+          put_varint(r, e.node.value.denominator);
+        }
+        if (e.flags & LEFT)
+          put_varint(r, zigzag(e.node.left - implied_left(e.index, count)));
+        if (e.flags & RIGHT)
+          put_varint(r, zigzag(e.node.right - implied_right(e.index, count)));
+        nodes.end_record();
+        last = e.index;
+      }
+      nodes.finish();
+
+      header.blocks = nodes.blocks;
+      ok            = out.flush();
+    }
+    ok = ok && pwrite(fd, &header, sizeof(header), 0) == sizeof(header);
+    ok = ok && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    ok = ok && rename(temporary.c_str(), path) == 0;
+    if (!ok)
+    {
+      fprintf(stderr, "checkpoint: failed writing `%s`: %s\n", path,
+              strerror(errno));
+      unlink(temporary.c_str());
+    }
+    return ok;
+  }
+
+  // Reads varints out of one block's records, noting any that run off the
+  // end.
+  struct Reader
+  {
+    const u8 *at, *end;
+    bool bad = false;
+
+    u64 varint(void)
+    {
+      u64 x = 0;
+      for (u64 shift = 0; shift < 64; shift += 7)
+      {
+        if (at == end)
+          break;
+        u8 byte = *at++;
+        x |= static_cast<u64>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+          return x;
+      }
+      bad = true;
+      return 0;
+    }
+  };
+
+  // Apply every record of one block.  Returns why it's no good, or nullptr.
+  static const char *apply_block(State &state, const BlockHeader &block,
+                                 const u8 *records)
+  {
+    std::vector<Node> &nodes = state.allocator.vec;
+    const u64 count          = nodes.size();
+    Reader in{records, records + block.bytes};
+    u64 last = 0;
+    for (u64 n = 0; n < block.records && !in.bad; ++n)
+    {
+      u64 delta = in.varint();
+      if (n > 0 && delta == 0)
+        return "nodes out of order";
+      const u64 index = (n == 0 ? 0 : last) + delta;
+      if (index >= count || index < last)
+        return "node out of range";
+      last          = index;
+      u64 flags     = in.varint();
+      Node &node    = nodes[index];
+      if (flags & VALUE)
+      {
+        // Fraction divides by the gcd, so check before making one.
+        u64 numerator = in.varint(), denominator = in.varint();
+        if (numerator == 0 || denominator == 0 ||
+            std::gcd(numerator, denominator) != 1)
+          return "bad value";
+        node.value = Fraction{numerator, denominator};
+      }
+      if (flags & LEFT)
+        node.left = implied_left(index, count) + unzigzag(in.varint());
+      if (flags & RIGHT)
+        node.right = implied_right(index, count) + unzigzag(in.varint());
+      if (node.left < -1 || node.left >= static_cast<i64>(count) ||
+          node.right < -1 || node.right >= static_cast<i64>(count))
+        return "link out of range";
+    }
+    if (in.bad || in.at != in.end)
+      return "records don't match their block";
+    return nullptr;
+  }
+
+  static const char *validate(const std::vector<u8> &file)
+  {
+    if (file.size() < sizeof(Header))
+      return "too short for a header";
+    const Header &header = *reinterpret_cast<const Header *>(file.data());
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+      return "not a compact checkpoint";
+    if (header.endian != cw::checkpoint::ENDIAN_TAG)
+      return "written with the other byte order";
+    if (header.version != VERSION)
+      return "written by a different version";
+    if (header.nodes == 0)
+      return "no nodes";
+
+    if (header.frontier != ~0ULL)
+      return "queue isn't the one the count implies";
+
+    // The count is all there is to most of the nodes, so the file's size
+    // can't bound it, but memory can: refuse to allocate more than the
+    // machine holds on the header's word.  Every block costs a header and
+    // each exception at least an index delta and flags, so those counts
+    // must fit what's left of the file.
+    const u64 memory = static_cast<u64>(sysconf(_SC_PHYS_PAGES)) *
+                       static_cast<u64>(sysconf(_SC_PAGESIZE));
+    const u64 body   = file.size() - sizeof(Header);
+    if (header.nodes > memory / sizeof(Node))
+      return "more nodes than memory holds";
+    if (header.exceptions > header.nodes)
+      return "more records than nodes";
+    if (header.blocks > body / sizeof(BlockHeader) ||
+        header.exceptions >
+            (body - (header.blocks * sizeof(BlockHeader))) / 2)
+      return "truncated";
+    return nullptr;
+  }
+
+  Restore restore(State &state, const char *path)
+  {
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+    {
+      if (errno == ENOENT)
+        return Restore::MISSING;
+      fprintf(stderr, "checkpoint: can't read `%s`: %s\n", path,
+              strerror(errno));
+      return Restore::FAILED;
+    }
+    std::vector<u8> file;
+    u8 buffer[1 << 16];
+    for (u64 got; (got = fread(buffer, 1, sizeof(buffer), fp)) > 0;)
+      file.insert(file.end(), buffer, buffer + got);
+    fclose(fp);
+
+    const char *problem = validate(file);
+    if (problem)
+    {
+      fprintf(stderr, "checkpoint: `%s`: %s\n", path, problem);
+      return Restore::FAILED;
+    }
+    Header header;
+    memcpy(&header, file.data(), sizeof(header));
+
+    // Everything the count implies, then the exceptions over the top.
+    const u64 count = header.nodes;
+    std::vector<Node> &nodes = state.allocator.vec;
+    nodes.resize(count);
+    parallel::for_range(0, count, [&](u64 begin, u64 end) {
+      Fraction value = cw::node::unrank(begin);
+      for (u64 i = begin; i < end; ++i)
+      {
+        nodes[i] = Node{Fraction{value}, implied_left(i, count),
+                        implied_right(i, count)};
+        if (i + 1 < end)
+          value = cw::node::next(value);
+      }
+    });
+
+    u64 offset = sizeof(Header), exceptions = 0;
+    for (u64 b = 0; b < header.blocks && !problem; ++b)
+    {
+      BlockHeader block;
+      if (file.size() - offset < sizeof(block))
+      {
+        problem = "truncated";
+        break;
+      }
+      memcpy(&block, file.data() + offset, sizeof(block));
+      offset += sizeof(block);
+      if (block.magic != BLOCK_MAGIC || block.section != Section::NODES)
+        problem = "bad block";
+      else if (file.size() - offset < block.bytes)
+        problem = "truncated";
+      else if (block_checksum(block, file.data() + offset) != block.checksum)
+        problem = "block checksum doesn't match";
+      else
+        problem = apply_block(state, block, file.data() + offset);
+      exceptions += block.records;
+      offset += block.bytes;
+    }
+    if (!problem && exceptions != header.exceptions)
+      problem = "missing exceptions";
+
+    if (problem)
+    {
+      fprintf(stderr, "checkpoint: `%s`: %s\n", path, problem);
+      return Restore::FAILED;
+    }
+    return Restore::RESTORED;
+  }
+} // namespace cw::compact
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
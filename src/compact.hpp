@@ -0,0 +1,103 @@
+/* compact.hpp: Checkpoints which only store what the count doesn't say
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef COMPACT_HPP
+#define COMPACT_HPP
+
+#include "base.hpp"
+#include "checkpoint.hpp"
+#include "state.hpp"
+
+namespace cw::compact
+{
+  // Generation is breadth first, so n nodes are always the first n of the
+  // tree: node i is unrank(i), the first (n - 1)/2 have children 2i + 1 and
+  // 2i + 2, and the rest are the work queue, in order.  A raw checkpoint
+  // spends 40 bytes a node on what the count alone says.  This one stores
+  // the count, then only exceptions to the above: nodes whose value or
+  // children aren't as implied.  Normally there are none, and the file is
+  // just the header.
+  //
+  //   Header | Block*
+  //
+  // Each Block is a BlockHeader then `bytes` of records for its section,
+  // with a checksum over them.  Records are varints (7 bits a byte, low
+  // first), with every index given as the difference from the one before
+  // it in the same block, so each block decodes on its own:
+  //   NODES:    index delta, flags (VALUE | LEFT | RIGHT), then for each
+  //             flag: numerator and denominator, or the link's difference
+  //             from the implied one, zigzagged (-1 for none)
+  //   FRONTIER: queue entry, zigzagged difference from the one before.
+  //             Never needed, as the queue is always as implied, so no
+  //             longer written; restore refuses files with any.
+  // Like raw checkpoints, restore refuses other versions or byte orders.
+  // cw::checkpoint::restore tells the two apart by their magic.
+  constexpr char MAGIC[8]   = {'C', 'W', 'T', 'R', 'E', 'E', 'C', 'P'};
+  constexpr u32 VERSION     = 1;
+  constexpr u32 BLOCK_MAGIC = 0x424b4343; // "CCKB"
+
+#ifndef COMPACT_BLOCK_RECORDS
+#define COMPACT_BLOCK_RECORDS (1 << 12)
+#endif
+
+  struct Header
+  {
+    char magic[8];
+    u32 endian, version;
+    u64 nodes;
+    u64 exceptions; // NODES records
+    u64 frontier;   // FRONTIER records, or ~0 if the queue is as implied
+                    // (which is all restore takes)
+    u64 blocks;
+  };
+
+  enum class Section : u32
+  {
+    NODES    = 1,
+    FRONTIER = 2,
+  };
+
+  struct BlockHeader
+  {
+    u32 magic;
+    Section section;
+    u32 records, bytes;
+    u64 checksum; // of the header so far and the records
+  };
+
+  enum Flags : u64
+  {
+    VALUE = 1,
+    LEFT  = 2,
+    RIGHT = 4,
+  };
+
+  // Like cw::checkpoint::save: written to a temporary file, synced and then
+  // renamed over `path`.  Finding the exceptions means comparing every node
+  // with what's implied, which is done in parallel.
+  bool save(const cw::state::State &, const char *path);
+
+  // Rebuild the nodes implied by the count (in parallel, a step of next()
+  // per node), then apply the exceptions.  The nodes can't be mapped in
+  // like a raw checkpoint's, as they aren't in the file.
+  cw::checkpoint::Restore restore(cw::state::State &, const char *path);
+} // namespace cw::compact
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
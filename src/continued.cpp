@@ -0,0 +1,123 @@
+/* continued.cpp: Continued fractions and run-length paths through the tree
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <utility>
+
+#include "continued.hpp"
+
+namespace cw::node
+{
+  std::vector<u64> expand(u64 p, u64 q)
+  {
+    std::vector<u64> quotients;
+    while (q != 0)
+    {
+      u64 a = p / q;
+      quotients.push_back(a);
+      p -= a * q;
+      std::swap(p, q);
+    }
+    return quotients;
+  }
+
+  Fraction reconstruct(const std::vector<u64> &quotients)
+  {
+    // Convergents h/k, seeded with h_-1/k_-1 = 1/0 and h_-2/k_-2 = 0/1.
+    u64 h = 1, k = 0, h_prev = 0, k_prev = 1;
+    for (u64 a : quotients)
+    {
+      u64 h_next = (a * h) + h_prev, k_next = (a * k) + k_prev;
+      h_prev     = h;
+      k_prev     = k;
+      h          = h_next;
+      k          = k_next;
+    }
+    return Fraction{h, k};
+  }
+
+  std::vector<Run> path(u64 p, u64 q)
+  {
+    std::vector<Run> runs;
+    for_each_run(p, q, [&](Run run) {
+      runs.push_back(run);
+      return true;
+    });
+    return runs;
+  }
+
+  Fraction follow(const std::vector<Run> &path)
+  {
+    // Bounds of the current subtree, whose root is their mediant.  k steps
+    // right move the left bound k times towards the right, and vice versa.
+    u64 lp = 0, lq = 1, rp = 1, rq = 0;
+    for (const Run &run : path)
+    {
+      if (run.right)
+      {
+        lp += run.length * rp;
+        lq += run.length * rq;
+      }
+      else
+      {
+        rp += run.length * lp;
+        rq += run.length * lq;
+      }
+    }
+    return Fraction{lp + rp, lq + rq};
+  }
+
+  std::vector<Run> quotients_to_path(const std::vector<u64> &quotients)
+  {
+    std::vector<Run> runs;
+    for (u64 i = 0; i < quotients.size(); ++i)
+    {
+      u64 length = quotients[i] - (i + 1 == quotients.size() ? 1 : 0);
+      if (length > 0)
+        runs.push_back(Run{i % 2 == 0, length});
+    }
+    return runs;
+  }
+
+  std::vector<u64> path_to_quotients(const std::vector<Run> &path)
+  {
+    // Quotients alternate right, left, right, ... starting from a0.
+    std::vector<u64> quotients{0};
+    for (const Run &run : path)
+    {
+      if (run.length == 0)
+        continue;
+      if (run.right != (quotients.size() % 2 == 1))
+        quotients.push_back(0);
+      quotients.back() += run.length;
+    }
+    ++quotients.back();
+    return quotients;
+  }
+
+  u64 depth_of(u64 p, u64 q)
+  {
+    u64 total = 0;
+    for_each_run(p, q, [&](Run run) {
+      total += run.length;
+      return true;
+    });
+    return total;
+  }
+} // namespace cw::node
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,95 @@
+/* continued.hpp: Continued fractions and run-length paths through the tree
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef CONTINUED_HPP
+#define CONTINUED_HPP
+
+#include <vector>
+
+#include "base.hpp"
+#include "node.hpp"
+
+namespace cw::node
+{
+  // p/q = [a0; a1, ..., an] = a0 + 1/(a1 + 1/(... + 1/an)), the quotients of
+  // the Euclidean algorithm on p and q.  The Stern-Brocot path from the root
+  // to p/q is R^a0 L^a1 R^a2 ... with the last run one short, so anything
+  // which walks that path can take a whole partial quotient per step instead
+  // of one step per level: O(number of quotients) rather than O(depth),
+  // which for 1/1000000 is 1 step rather than 999999.
+
+  // A run of `length` identical steps down the Stern-Brocot tree.  The
+  // Calkin-Wilf path to the same fraction is the same runs in reverse.
+  struct Run
+  {
+    bool right;
+    u64 length;
+  };
+
+  // Call f(run) for each run of the Stern-Brocot path to p/q, from the root
+  // down, for as long as f returns true.  Each run is one division: p > q
+  // takes (p - 1)/q steps right to (p mod q)/q (or 1/1), p < q the same
+  // leftwards.  Returns what's left of p, which once walked to the end is
+  // gcd(p, q): it's only p/q's path if that's 1.  p and q must be nonzero.
+  template <typename F>
+  u64 for_each_run(u64 p, u64 q, F &&f)
+  {
+    while (p != q)
+    {
+      Run run{p > q, p > q ? (p - 1) / q : (q - 1) / p};
+      if (run.right)
+        p -= run.length * q;
+      else
+        q -= run.length * p;
+      if (!f(run))
+        break;
+    }
+    return p;
+  }
+
+  // Partial quotients of numerator/denominator (denominator nonzero), in
+  // canonical form: the last is at least 2 unless the value is an integer.
+  std::vector<u64> expand(u64 numerator, u64 denominator);
+
+  // The fraction [a0; a1, ..., an] from its partial quotients, by the
+  // recurrence for convergents.  Wraps if it doesn't fit in 64 bits.
+  Fraction reconstruct(const std::vector<u64> &quotients);
+
+  // Stern-Brocot path to numerator/denominator as runs, from the root down.
+  // Empty for 1/1.  Both must be nonzero and the fraction reduced.
+  std::vector<Run> path(u64 numerator, u64 denominator);
+
+  // The fraction at the end of a Stern-Brocot path, a run at a time.
+  // Consecutive runs in the same direction are fine, as are empty ones.
+  Fraction follow(const std::vector<Run> &path);
+
+  // Conversions between the two: the runs are the quotients, except that a
+  // leading 0 quotient (a value below 1) has no run and the last run is one
+  // short.
+  std::vector<Run> quotients_to_path(const std::vector<u64> &quotients);
+  std::vector<u64> path_to_quotients(const std::vector<Run> &path);
+
+  // Depth of numerator/denominator in either tree: the sum of its partial
+  // quotients less 1, what depth(index) gives for its index.  Both must be
+  // nonzero and the fraction reduced.
+  u64 depth_of(u64 numerator, u64 denominator);
+} // namespace cw::node
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
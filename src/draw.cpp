@@ -0,0 +1,673 @@
+/* draw.cpp: Batched render geometry and the tree (graph) view
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <raylib.h>
+#include <raymath.h>
+#include <rlgl.h>
+
+#include "draw.hpp"
+#include "node.hpp"
+#include "parallel.hpp"
+
+namespace cw::draw
+{
+  using cw::node::Fraction;
+
+  // Number of primitives pushed between checks of the rlgl batch limit.
+  constexpr u64 BATCH_CHUNK = 1024;
+
+  void Geometry::clear(void)
+  {
+    lines.clear();
+    line_colours.clear();
+    points.clear();
+    point_colours.clear();
+  }
+
+  static void submit_lines(const Geometry &geom, u64 begin, u64 end)
+  {
+    for (u64 i = begin; i < end; i += BATCH_CHUNK)
+    {
+      u64 chunk_end = MIN(end, i + BATCH_CHUNK);
+      rlCheckRenderBatchLimit(2 * (chunk_end - i));
+      rlBegin(RL_LINES);
+      for (u64 j = i; j < chunk_end; ++j)
+      {
+        Color c = geom.line_colours[j];
+        rlColor4ub(c.r, c.g, c.b, c.a);
+        rlVertex2f(geom.lines[2 * j].x, geom.lines[2 * j].y);
+        rlVertex2f(geom.lines[(2 * j) + 1].x, geom.lines[(2 * j) + 1].y);
+      }
+      rlEnd();
+    }
+  }
+
+  static void submit_points(const Geometry &geom, f32 point_size, u64 begin,
+                            u64 end)
+  {
+    const f32 half = point_size / 2;
+    for (u64 i = begin; i < end; i += BATCH_CHUNK)
+    {
+      u64 chunk_end = MIN(end, i + BATCH_CHUNK);
+      rlCheckRenderBatchLimit(4 * (chunk_end - i));
+      rlBegin(RL_QUADS);
+      for (u64 j = i; j < chunk_end; ++j)
+      {
+        Color c   = geom.point_colours[j];
+        Vector2 p = geom.points[j];
+        rlColor4ub(c.r, c.g, c.b, c.a);
+        rlVertex2f(p.x - half, p.y - half);
+        rlVertex2f(p.x - half, p.y + half);
+        rlVertex2f(p.x + half, p.y + half);
+        rlVertex2f(p.x + half, p.y - half);
+      }
+      rlEnd();
+    }
+  }
+
+  void submit(const Geometry &geom, f32 point_size)
+  {
+    submit_lines(geom, 0, geom.line_colours.size());
+    submit_points(geom, point_size, 0, geom.point_colours.size());
+  }
+
+  Progressive::Progressive(int width, int height)
+      : target{LoadRenderTexture(width, height)}, lines{0}, points{0}
+  {
+    reset();
+  }
+
+  void Progressive::unload(void)
+  {
+    UnloadRenderTexture(target);
+  }
+
+  void Progressive::reset(void)
+  {
+    lines  = 0;
+    points = 0;
+    BeginTextureMode(target);
+    ClearBackground(BLANK);
+    EndTextureMode();
+  }
+
+  bool Progressive::step(const Geometry &geom, const Camera2D &camera,
+                         f32 point_size)
+  {
+    using Clock        = std::chrono::steady_clock;
+    const u64 n_lines  = geom.line_colours.size();
+    const u64 n_points = geom.point_colours.size();
+    if (lines >= n_lines && points >= n_points)
+      return true;
+
+    const auto deadline =
+        Clock::now() + std::chrono::milliseconds(FRAME_BUDGET_MS);
+    BeginTextureMode(target);
+    BeginMode2D(camera);
+    while ((lines < n_lines || points < n_points) && Clock::now() < deadline)
+    {
+      if (lines < n_lines)
+      {
+        u64 end = MIN(n_lines, lines + BATCH_CHUNK);
+        submit_lines(geom, lines, end);
+        lines = end;
+      }
+      else
+      {
+        u64 end = MIN(n_points, points + BATCH_CHUNK);
+        submit_points(geom, point_size, points, end);
+        points = end;
+      }
+    }
+    EndMode2D();
+    EndTextureMode();
+    return lines >= n_lines && points >= n_points;
+  }
+
+  void Progressive::draw(void) const
+  {
+    // Render textures are upside down.
+    Rectangle source = {0, 0, static_cast<f32>(target.texture.width),
+                        -static_cast<f32>(target.texture.height)};
+    DrawTextureRec(target.texture, source, {0, 0}, WHITE);
+  }
+
+  // Clip the segment a-b to the rectangle [0, width] x [0, height]
+  // (Liang-Barsky).  Returns false if nothing of it is left.
+  static bool clip_line(Vector2 &a, Vector2 &b, f32 width, f32 height)
+  {
+    f32 t0 = 0, t1 = 1;
+    f32 dx = b.x - a.x, dy = b.y - a.y;
+    const f32 p[4] = {-dx, dx, -dy, dy};
+    const f32 q[4] = {a.x, width - a.x, a.y, height - a.y};
+    for (int i = 0; i < 4; ++i)
+    {
+      if (p[i] == 0)
+      {
+        if (q[i] < 0)
+          return false;
+        continue;
+      }
+      f32 t = q[i] / p[i];
+      if (p[i] < 0)
+        t0 = MAX(t0, t);
+      else
+        t1 = MIN(t1, t);
+      if (t0 > t1)
+        return false;
+    }
+    b = {a.x + (t1 * dx), a.y + (t1 * dy)};
+    a = {a.x + (t0 * dx), a.y + (t0 * dy)};
+    return true;
+  }
+
+  void rasterise(const Geometry &geom, Image &image, const Camera2D &camera,
+                 int point_size)
+  {
+    const f32 width = image.width - 1, height = image.height - 1;
+    for (u64 i = 0; i < geom.line_colours.size(); ++i)
+    {
+      Vector2 a = GetWorldToScreen2D(geom.lines[2 * i], camera);
+      Vector2 b = GetWorldToScreen2D(geom.lines[(2 * i) + 1], camera);
+      if (!clip_line(a, b, width, height))
+        continue;
+      ImageDrawLine(&image, a.x, a.y, b.x, b.y, geom.line_colours[i]);
+    }
+
+    for (u64 i = 0; i < geom.point_colours.size(); ++i)
+    {
+      Vector2 p = GetWorldToScreen2D(geom.points[i], camera);
+      if (p.x < 0 || p.x > width || p.y < 0 || p.y > height)
+        continue;
+      ImageDrawRectangle(&image, p.x - (point_size / 2), p.y - (point_size / 2),
+                         point_size, point_size, geom.point_colours[i]);
+    }
+  }
+
+  Vector2 Camera::to_screen(Point world) const
+  {
+    return {static_cast<f32>(((world.x - target.x) * zoom) + offset.x),
+            static_cast<f32>(((world.y - target.y) * zoom) + offset.y)};
+  }
+
+  Point Camera::to_world(Vector2 screen) const
+  {
+    return {target.x + ((screen.x - offset.x) / zoom),
+            target.y + ((screen.y - offset.y) / zoom)};
+  }
+
+  void Camera::pan(Vector2 delta)
+  {
+    target.x -= delta.x / zoom;
+    target.y -= delta.y / zoom;
+  }
+
+  void Camera::zoom_at(Vector2 screen, f64 factor, f64 min, f64 max)
+  {
+    target = to_world(screen);
+    offset = screen;
+    zoom   = std::clamp<f64>(zoom * factor, min, max);
+  }
+
+  // a + b == sum + error exactly (Knuth's two-sum).
+  static f64 two_sum(f64 a, f64 b, f64 &error)
+  {
+    f64 sum = a + b;
+    f64 bb  = sum - a;
+    error   = (a - (sum - bb)) + (b - bb);
+    return sum;
+  }
+
+  bool Camera::rebase(void)
+  {
+    if (std::abs(target.x) * zoom < REBASE_PIXELS &&
+        std::abs(target.y) * zoom < REBASE_PIXELS)
+      return false;
+    // Whatever doesn't fit in the new origin stays in the target, so the
+    // absolute target doesn't move by so much as a rounding error.
+    origin.x = two_sum(origin.x, target.x, target.x);
+    origin.y = two_sum(origin.y, target.y, target.y);
+    return true;
+  }
+
+  Camera2D Camera::relative(void) const
+  {
+    Camera2D camera;
+    camera.target   = {static_cast<f32>(target.x), static_cast<f32>(target.y)};
+    camera.offset   = offset;
+    camera.rotation = 0.0f;
+    camera.zoom     = zoom;
+    return camera;
+  }
+
+  bool Camera::operator==(const Camera &other) const
+  {
+    return origin.x == other.origin.x && origin.y == other.origin.y &&
+           target.x == other.target.x && target.y == other.target.y &&
+           offset.x == other.offset.x && offset.y == other.offset.y &&
+           zoom == other.zoom;
+  }
+
+  Camera default_camera(void)
+  {
+    return Camera{{0, 0}, {0, 0}, {WIDTH / 16, 0}, 0.8};
+  }
+
+  Viewport viewport(const Camera &camera, int width, int height)
+  {
+    Point top_left     = camera.to_world({0, 0});
+    Point bottom_right = camera.to_world(
+        {static_cast<f32>(width), static_cast<f32>(height)});
+    return Viewport{top_left.x, top_left.y, bottom_right.x, bottom_right.y};
+  }
+
+  LineMap::LineMap(const cw::state::DrawState &ds, Point origin)
+      : scale{WIDTH / (ds.bounds.upper_val - ds.bounds.lower_val)}
+  {
+    origin_value = ds.bounds.lower_val + (origin.x / scale);
+  }
+
+  using cw::state::DrawState;
+  using Colouring = DrawState::Colouring;
+
+  // Every colouring maps a node to one of 256 keys, and the palette maps keys
+  // to colours.  So the per node work is a little integer arithmetic and a
+  // table lookup rather than HSV maths.
+  struct Palette
+  {
+    Color colours[256];
+
+    Palette(Colouring colouring)
+    {
+      for (u64 key = 0; key < 256; ++key)
+      {
+        f32 t = key / 255.0f;
+        switch (colouring)
+        {
+        case Colouring::PLAIN:
+          colours[key] = RED;
+          break;
+        case Colouring::DEPTH:
+          colours[key] = ColorFromHSV(240 * t, 0.8f, 1.0f);
+          break;
+        case Colouring::RECENCY:
+          // Old nodes are a dim red, the newest are a bright yellow.
+          colours[key] = ColorFromHSV(60 * t, 0.9f, 0.3f + (0.7f * t));
+          break;
+        case Colouring::POSITION:
+          colours[key] = ColorFromHSV(300 * t, 0.8f, 1.0f);
+          break;
+        }
+      }
+    }
+  };
+
+  static inline u8 colour_key(Colouring colouring, u64 index, u64 depth,
+                              f64 norm, u64 count, u64 max_depth,
+                              f64 upper_val)
+  {
+    switch (colouring)
+    {
+    case Colouring::PLAIN:
+      return 0;
+    case Colouring::DEPTH:
+      return (255.0 * depth) / MAX(1, max_depth);
+    case Colouring::RECENCY:
+      return (255.0 * index) / MAX(1, count - 1);
+    case Colouring::POSITION:
+      return 255 * Clamp(norm / upper_val, 0, 1);
+    }
+    return 0;
+  }
+
+  // The number line itself and its bounds.
+  constexpr u64 AXES = 3;
+  static void add_axes(Geometry &geom, const LineMap &map,
+                       const DrawState &ds, Point origin)
+  {
+    const f32 left   = map.x(ds.bounds.lower_val);
+    const f32 right  = map.x(ds.bounds.upper_val);
+    const f32 middle = (HEIGHT / 2) - origin.y;
+    const f32 top = LINE_TOP - origin.y, bottom = LINE_BOTTOM - origin.y;
+    geom.lines.insert(geom.lines.end(), {{left, middle},
+                                         {right, middle},
+                                         {left, top},
+                                         {left, bottom},
+                                         {right, top},
+                                         {right, bottom}});
+    geom.line_colours.insert(geom.line_colours.end(), {WHITE, WHITE, WHITE});
+  }
+
+  NumberLine::NumberLine(void)
+      : origin_value{0}, scale{0}, origin_y{0}, colouring{Colouring::PLAIN},
+        max_depth{0}
+  {
+  }
+
+  // Blocks of a fixed size, so that the compiler vectorises the inner loop
+  // even at -O2.
+  constexpr u64 POSITION_BLOCK = 8;
+
+  static void positions(f32 *xs, const f64 *norms, u64 begin, u64 end,
+                        f64 origin_value, f64 scale)
+  {
+    u64 i = begin;
+    for (; i + POSITION_BLOCK <= end; i += POSITION_BLOCK)
+      for (u64 j = 0; j < POSITION_BLOCK; ++j)
+        xs[i + j] = (norms[i + j] - origin_value) * scale;
+    for (; i < end; ++i)
+      xs[i] = (norms[i] - origin_value) * scale;
+  }
+
+  bool NumberLine::update(const f64 *norms, u64 count, const DrawState &ds,
+                          Point origin)
+  {
+    const LineMap map{ds, origin};
+    const u64 old_count = xs.size();
+    const u64 depth     = count == 0 ? 0 : cw::node::depth(count - 1);
+
+    // Position colouring depends on the bounds, so moving recolours too.
+    bool moved = map.origin_value != origin_value || map.scale != scale ||
+                 origin.y != origin_y || count < old_count;
+    bool recolour = moved || ds.colouring != colouring ||
+                    ds.colouring == Colouring::RECENCY ||
+                    (ds.colouring == Colouring::DEPTH && depth != max_depth);
+    const u64 move_from   = moved ? 0 : old_count;
+    const u64 colour_from = recolour ? 0 : old_count;
+    origin_value          = map.origin_value;
+    scale                 = map.scale;
+    origin_y              = origin.y;
+    colouring             = ds.colouring;
+    max_depth             = depth;
+
+    xs.resize(count);
+    parallel::for_range(move_from, count, [&](u64 begin, u64 end) {
+      positions(xs.data(), norms, begin, end, map.origin_value, map.scale);
+    });
+
+    // The line itself and its bounds come first.
+    if (moved)
+    {
+      geometry.clear();
+      add_axes(geometry, map, ds, origin);
+    }
+    geometry.lines.resize(2 * (AXES + count));
+    geometry.line_colours.resize(AXES + count);
+
+    const f64 upper_val = ds.bounds.upper_val;
+    const f32 top = LINE_TOP - origin.y, bottom = LINE_BOTTOM - origin.y;
+    const Palette palette{ds.colouring};
+    parallel::for_range(MIN(move_from, colour_from), count,
+                        [&](u64 begin, u64 end) {
+                          Vector2 *lines = geometry.lines.data() + (2 * AXES);
+                          Color *colours = geometry.line_colours.data() + AXES;
+                          for (u64 i = MAX(begin, move_from); i < end; ++i)
+                          {
+                            lines[2 * i]       = {xs[i], top};
+                            lines[(2 * i) + 1] = {xs[i], bottom};
+                          }
+                          for (u64 i = MAX(begin, colour_from); i < end; ++i)
+                            colours[i] = palette.colours[colour_key(
+                                ds.colouring, i, cw::node::depth(i), norms[i],
+                                count, depth, upper_val)];
+                        });
+
+    return MIN(move_from, colour_from) < old_count;
+  }
+
+  void build_deep_zoom(Geometry &geom, std::vector<cw::node::Located> &found,
+                       const Viewport &view, const DrawState &ds, Point origin)
+  {
+    geom.clear();
+    found.clear();
+    const LineMap map{ds, origin};
+    add_axes(geom, map, ds, origin);
+
+    const f64 lower_val = ds.bounds.lower_val, upper_val = ds.bounds.upper_val;
+    f64 lower = MAX(map.value(view.left), lower_val);
+    f64 upper = MIN(map.value(view.right), upper_val);
+    if (upper <= lower)
+      return;
+
+    // Fractions with denominators at most q are at least 1/q^2 apart.
+    f64 pixel           = (upper - lower) / WIDTH;
+    u64 max_denominator = MAX(1, std::sqrt(1 / pixel));
+    cw::node::enumerate_interval(lower, upper, DEEP_ZOOM_MAX_DEPTH,
+                                 max_denominator, 4 * WIDTH, found);
+
+    u64 max_depth = 0;
+    for (const auto &located : found)
+      max_depth = MAX(max_depth, located.depth);
+
+    // Nothing here has a BFS index, so recency is meaningless.
+    const f32 top = LINE_TOP - origin.y, bottom = LINE_BOTTOM - origin.y;
+    const Palette palette{ds.colouring};
+    for (const auto &located : found)
+    {
+      f32 x  = map.x(located.value.norm);
+      u8 key = colour_key(ds.colouring, 0, located.depth, located.value.norm, 1,
+                          max_depth, upper_val);
+      geom.lines.push_back({x, top});
+      geom.lines.push_back({x, bottom});
+      geom.line_colours.push_back(palette.colours[key]);
+    }
+  }
+
+  // A run of consecutive BFS indices on one level of the tree, along with
+  // where its output starts among the nodes being added.
+  struct Span
+  {
+    u64 first, size, depth, out;
+  };
+
+  // Append the nodes with indices in [from, count) which lie inside `view`.
+  static void add_nodes(Geometry &geom, const Viewport &view, f32 width,
+                        u64 from, u64 count, const DrawState &ds,
+                        u64 max_per_level, u64 max_depth, Point origin)
+  {
+    if (from >= count)
+      return;
+
+    // Culling works in absolute world positions.
+    const f64 left = view.left + origin.x, right = view.right + origin.x;
+    f64 top    = std::floor((view.top + origin.y) / GRAPH_LEVEL_HEIGHT);
+    f64 bottom = std::ceil((view.bottom + origin.y) / GRAPH_LEVEL_HEIGHT);
+    if (bottom < 0 || top > max_depth)
+      return;
+    u64 depth_lo = top < 0 ? 0 : top;
+    u64 depth_hi = MIN(max_depth, static_cast<u64>(bottom));
+
+    std::vector<Span> spans;
+    u64 total = 0;
+    for (u64 depth = depth_lo; depth <= depth_hi; ++depth)
+    {
+      u64 level_size = 1ULL << depth;
+      f64 spacing    = width / static_cast<f64>(level_size);
+      f64 k_lo       = std::floor(left / spacing);
+      f64 k_hi       = std::ceil(right / spacing);
+      if (k_hi < 0 || k_lo >= level_size)
+        continue;
+      u64 lo = k_lo < 0 ? 0 : k_lo;
+      u64 hi = MIN(level_size - 1, static_cast<u64>(k_hi));
+      if (hi - lo + 1 > max_per_level)
+        break;
+
+      u64 first = level_size - 1 + lo;
+      if (first >= count)
+        break;
+      u64 end = MIN(count, first + (hi - lo + 1));
+      first   = MAX(first, from);
+      if (first >= end)
+        continue;
+      spans.push_back(Span{first, end - first, depth, total});
+      total += end - first;
+    }
+
+    const u64 base = geom.point_colours.size();
+    geom.points.resize(base + total);
+    geom.point_colours.resize(base + total);
+    geom.lines.resize(2 * (base + total));
+    geom.line_colours.resize(base + total);
+
+    const f64 upper_val = ds.bounds.upper_val;
+    const Palette palette{ds.colouring};
+    parallel::for_range(0, total, [&](u64 begin, u64 end) {
+      // Find the span containing `begin`, then walk spans from there.
+      auto span = std::upper_bound(
+                      spans.begin(), spans.end(), begin,
+                      [](u64 out, const Span &s) { return out < s.out; }) -
+                  1;
+      for (u64 out = begin; out < end; ++span)
+      {
+        u64 offset    = out - span->out;
+        u64 index     = span->first + offset;
+        u64 span_end  = MIN(end, span->out + span->size);
+        f64 spacing   = width / static_cast<f64>(1ULL << span->depth);
+        u64 k         = index + 1 - (1ULL << span->depth);
+        f64 y = ((span->depth + 0.5) * GRAPH_LEVEL_HEIGHT) - origin.y;
+        Fraction frac = cw::node::unrank(index);
+        for (; out < span_end; ++out, ++k, frac = cw::node::next(frac))
+        {
+          Vector2 pos  = {static_cast<f32>(((k + 0.5) * spacing) - origin.x),
+                          static_cast<f32>(y)};
+          u8 key       = colour_key(ds.colouring, span->first + out - span->out,
+                                    span->depth, frac.norm, count, max_depth,
+                                    upper_val);
+          Color colour = palette.colours[key];
+
+          // The root has no parent, so its edge is degenerate.
+          Vector2 parent = pos;
+          if (span->depth > 0)
+            parent = {
+                static_cast<f32>((((k / 2) + 0.5) * 2 * spacing) - origin.x),
+                static_cast<f32>(y - GRAPH_LEVEL_HEIGHT)};
+
+          const u64 at             = base + out;
+          geom.points[at]          = pos;
+          geom.point_colours[at]   = colour;
+          geom.lines[2 * at]       = parent;
+          geom.lines[(2 * at) + 1] = pos;
+          geom.line_colours[at]    = Fade(colour, 0.5f);
+        }
+      }
+    });
+  }
+
+  Graph::Graph(void)
+      : view{0, 0, 0, 0}, origin{0, 0}, width{0}, max_per_level{0}, count{0},
+        colouring{Colouring::PLAIN}, max_depth{0}, upper_val{0}
+  {
+  }
+
+  bool Graph::update(const Viewport &view, f32 width, u64 count,
+                     const DrawState &ds, u64 max_per_level, Point origin)
+  {
+    const u64 old_count = this->count;
+    const u64 depth     = count == 0 ? 0 : cw::node::depth(count - 1);
+
+    // Positions only depend on the view; colours on the count (recency), the
+    // depth reached or the bounds (position).
+    bool moved = view.left != this->view.left ||
+                 view.top != this->view.top ||
+                 view.right != this->view.right ||
+                 view.bottom != this->view.bottom ||
+                 origin.x != this->origin.x || origin.y != this->origin.y ||
+                 width != this->width ||
+                 max_per_level != this->max_per_level || count < old_count;
+    bool recolour =
+        moved || ds.colouring != colouring ||
+        (ds.colouring == Colouring::RECENCY && count != old_count) ||
+        (ds.colouring == Colouring::DEPTH && depth != max_depth) ||
+        (ds.colouring == Colouring::POSITION &&
+         ds.bounds.upper_val != upper_val);
+    const u64 from      = recolour ? 0 : old_count;
+    this->view          = view;
+    this->origin        = origin;
+    this->width         = width;
+    this->max_per_level = max_per_level;
+    this->count         = count;
+    colouring           = ds.colouring;
+    max_depth           = depth;
+    upper_val           = ds.bounds.upper_val;
+
+    if (recolour)
+      geometry.clear();
+    add_nodes(geometry, view, width, from, count, ds, max_per_level, depth,
+              origin);
+    return from < old_count;
+  }
+
+  // Position of node `index` in the tree view, relative to the origin.
+  static Vector2 graph_position(u64 index, f32 width, Point origin)
+  {
+    u64 depth   = cw::node::depth(index);
+    f64 spacing = width / static_cast<f64>(1ULL << depth);
+    u64 k       = index + 1 - (1ULL << depth);
+    return {static_cast<f32>(((k + 0.5) * spacing) - origin.x),
+            static_cast<f32>(((depth + 0.5) * GRAPH_LEVEL_HEIGHT) - origin.y)};
+  }
+
+  void build_highlights(Geometry &geom, const u64 *generators, u64 n,
+                        f32 width, const DrawState &ds, Point origin)
+  {
+    geom.clear();
+    // Children go first, so that generators are drawn over them.
+    if (ds.view == DrawState::View::GRAPH)
+    {
+      for (u64 i = 0; i < n; ++i)
+      {
+        Vector2 parent = graph_position(generators[i], width, origin);
+        for (u64 child : {(2 * generators[i]) + 1, (2 * generators[i]) + 2})
+        {
+          Vector2 pos = graph_position(child, width, origin);
+          geom.lines.insert(geom.lines.end(), {parent, pos});
+          geom.line_colours.push_back(BLUE);
+          geom.points.push_back(pos);
+          geom.point_colours.push_back(BLUE);
+        }
+      }
+      for (u64 i = 0; i < n; ++i)
+      {
+        geom.points.push_back(graph_position(generators[i], width, origin));
+        geom.point_colours.push_back(GREEN);
+      }
+      return;
+    }
+
+    const LineMap map{ds, origin};
+    const f32 top = LINE_TOP - origin.y, bottom = LINE_BOTTOM - origin.y;
+    auto tick     = [&](u64 index, Color colour) {
+      f32 x = map.x(cw::node::unrank(index).norm);
+      geom.lines.insert(geom.lines.end(), {{x, top}, {x, bottom}});
+      geom.line_colours.push_back(colour);
+    };
+    for (u64 i = 0; i < n; ++i)
+    {
+      tick((2 * generators[i]) + 1, BLUE);
+      tick((2 * generators[i]) + 2, BLUE);
+    }
+    for (u64 i = 0; i < n; ++i)
+      tick(generators[i], GREEN);
+  }
+} // namespace cw::draw
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,264 @@
+/* draw.hpp: Batched render geometry and the tree (graph) view
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef DRAW_HPP
+#define DRAW_HPP
+
+#include <vector>
+
+#include <raylib.h>
+
+#include "base.hpp"
+#include "state.hpp"
+#include "stern_brocot.hpp"
+
+#define WIDTH       1024
+#define HEIGHT      800
+#define FONT_SIZE   20
+#define CIRCLE_SIZE 2
+#define LINE_TOP    (7 * HEIGHT / 16)
+#define LINE_BOTTOM (9 * HEIGHT / 16)
+
+namespace cw::draw
+{
+  // Geometry is built off to the side (in parallel where it pays) and then
+  // submitted to rlgl in one batch, rather than issuing a raylib draw call per
+  // node.
+  struct Geometry
+  {
+    // Endpoints of each line, in pairs, with one colour per line.
+    std::vector<Vector2> lines;
+    std::vector<Color> line_colours;
+
+    // Centres of each point, with one colour per point.
+    std::vector<Vector2> points;
+    std::vector<Color> point_colours;
+
+    void clear(void);
+  };
+
+  // Submit all of the geometry through rlgl.  Points are drawn as squares of
+  // side `point_size` in world units.
+  void submit(const Geometry &, f32 point_size);
+
+#ifndef FRAME_BUDGET_MS
+#define FRAME_BUDGET_MS 8
+#endif
+
+  // Draws geometry into a persistent render target a slice at a time, spending
+  // at most FRAME_BUDGET_MS per frame and carrying on where it left off next
+  // frame.  Large views converge over a few frames rather than stalling every
+  // one.  Geometry which only grows at the end (new nodes) carries on from the
+  // cursor; anything else (camera moved, bounds changed) needs a reset.
+  struct Progressive
+  {
+    RenderTexture2D target;
+    u64 lines, points; // how much of the geometry has been drawn so far
+
+    // Needs a window, as it allocates a render texture; unload() before
+    // closing it.
+    Progressive(int width, int height);
+    void unload(void);
+
+    void reset(void);
+    // Draw more of the geometry into the target.  Returns true once all of it
+    // has been drawn.
+    bool step(const Geometry &, const Camera2D &, f32 point_size);
+    // Draw the target onto the screen.
+    void draw(void) const;
+  };
+
+  // Draw all of the geometry into `image` on the CPU, as seen through
+  // `camera`.  Needs no window or GL context.  Points are squares of side
+  // `point_size` in pixels.
+  void rasterise(const Geometry &, Image &image, const Camera2D &camera,
+                 int point_size);
+
+  // A position in world space, in double precision.
+  struct Point
+  {
+    f64 x, y;
+  };
+
+#ifndef REBASE_PIXELS
+#define REBASE_PIXELS (1 << 20)
+#endif
+
+  // Camera2D keeps its target and zoom in floats, so once zoomed in far
+  // enough neighbouring ticks land on the same pixel and jitter as the camera
+  // moves.  This camera works in doubles, relative to an origin: geometry is
+  // built relative to the same origin, so vertices near the target are small
+  // numbers and stay exact as floats.  Every world position below (targets,
+  // viewports, vertices) is relative to the origin.
+  struct Camera
+  {
+    Point origin;   // absolute world position
+    Point target;   // world position shown at offset
+    Vector2 offset; // screen position
+    f64 zoom;
+
+    Vector2 to_screen(Point world) const;
+    Point to_world(Vector2 screen) const;
+
+    // Move by `delta` pixels on screen.
+    void pan(Vector2 delta);
+    // Scale the zoom by `factor` (clamped to [min, max]), keeping the world
+    // under `screen` where it is.
+    void zoom_at(Vector2 screen, f64 factor, f64 min, f64 max);
+
+    // Move the origin onto the target once they are more than REBASE_PIXELS
+    // apart on screen, beyond which float vertices around the target lose
+    // precision.  Nothing visibly moves.  Returns true if the origin moved,
+    // in which case all geometry must be rebuilt.
+    bool rebase(void);
+
+    // The raylib camera for geometry built relative to the origin.
+    Camera2D relative(void) const;
+
+    bool operator==(const Camera &) const;
+    bool operator!=(const Camera &other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  // Camera we start every view with.
+  Camera default_camera(void);
+
+  // Region of world space visible through a camera.
+  struct Viewport
+  {
+    f64 left, top, right, bottom;
+  };
+
+  Viewport viewport(const Camera &, int width, int height);
+
+  // Where values lie on the number line, which spans world [0, WIDTH] for
+  // values [lower_val, upper_val].  Positions relative to the origin are
+  // worked out as differences of values rather than of world positions, so
+  // they keep their precision however far in the camera is zoomed.
+  struct LineMap
+  {
+    f64 origin_value, scale;
+
+    LineMap(const cw::state::DrawState &, Point origin);
+
+    f64 x(f64 norm) const
+    {
+      return (norm - origin_value) * scale;
+    }
+
+    f64 value(f64 x) const
+    {
+      return origin_value + (x / scale);
+    }
+  };
+
+  // Both views colour nodes by ds.colouring, worked out in the same pass
+  // that lays them out.  Depth comes from the index, so no view needs more
+  // than the norms of each node.
+
+  // All of them build geometry relative to `origin`, the camera's origin.
+
+  // Number line view: a tick at Remap(norm, lower_val, upper_val, 0, WIDTH)
+  // for each fraction, plus the line itself and its bounds.  Kept up to date
+  // as nodes arrive rather than built from scratch: tick positions are cached
+  // in a contiguous array, and only recomputed (in parallel) when the bounds
+  // or the origin move, which happens about once per level.  Colours are
+  // only recomputed when the colouring depends on something that changed.
+  // Otherwise new nodes are just appended.
+  struct NumberLine
+  {
+    Geometry geometry;
+    std::vector<f32> xs; // x of each tick, relative to the origin
+
+    NumberLine(void);
+
+    // Bring the view up to date with the first `count` fractions in `norms`.
+    // Returns true if any geometry already there changed, rather than just
+    // being appended to.
+    bool update(const f64 *norms, u64 count, const cw::state::DrawState &ds,
+                Point origin);
+
+  private:
+    // What the cached positions and colours were worked out for.
+    f64 origin_value, scale, origin_y;
+    cw::state::DrawState::Colouring colouring;
+    u64 max_depth;
+  };
+
+#ifndef DEEP_ZOOM_MAX_DEPTH
+#define DEEP_ZOOM_MAX_DEPTH (1 << 24)
+#endif
+
+  // Deep zoom view: a tick for every fraction on the visible part of the
+  // number line, found by descending the tree to the view rather than
+  // generating the tree down to it.  Denominators are capped so that ticks
+  // stay about a pixel apart.  The fractions found are left in `found`, in
+  // increasing order.
+  void build_deep_zoom(Geometry &, std::vector<cw::node::Located> &found,
+                       const Viewport &view, const cw::state::DrawState &ds,
+                       Point origin);
+
+  // Tree view: node i sits at depth d = floor(log2(i + 1)) and at position k =
+  // i + 1 - 2^d within that level, so its world position is implicit:
+  //   x = (k + 0.5) * width / 2^d, y = (d + 0.5) * GRAPH_LEVEL_HEIGHT
+  constexpr f32 GRAPH_LEVEL_HEIGHT = 64;
+
+  // Geometry for the first `count` nodes of the tree which lie inside a view.
+  // Levels are culled by depth and each level is clipped to the horizontal
+  // range of the view.  Once a level would need more than `max_per_level`
+  // nodes (i.e. they are denser than the pixels on screen) it and all deeper
+  // levels are skipped.  Like the number line, kept up to date as nodes
+  // arrive: positions don't depend on the count, so unless the view moves or
+  // the colours change, new nodes in view are just appended.
+  struct Graph
+  {
+    Geometry geometry;
+
+    Graph(void);
+
+    // Bring the view up to date with the first `count` nodes.  Returns true
+    // if any geometry already there changed, rather than just being appended
+    // to.
+    bool update(const Viewport &view, f32 width, u64 count,
+                const cw::state::DrawState &ds, u64 max_per_level,
+                Point origin);
+
+  private:
+    // What the geometry was built for, and for how many nodes.
+    Viewport view;
+    Point origin;
+    f32 width;
+    u64 max_per_level, count;
+    cw::state::DrawState::Colouring colouring;
+    u64 max_depth;
+    f64 upper_val;
+  };
+
+  // Overlay of the most recent expansions, for whichever view is up: each
+  // generator in green and its children (nodes 2i + 1 and 2i + 2) in blue.
+  // Values come straight from the indices, so these may well be newer than
+  // any snapshot.
+  void build_highlights(Geometry &, const u64 *generators, u64 n, f32 width,
+                        const cw::state::DrawState &ds, Point origin);
+} // namespace cw::draw
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
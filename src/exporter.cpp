@@ -0,0 +1,516 @@
+/* exporter.cpp: Streaming generated nodes out to a file, asynchronously
+ * Created: 2026-10-19
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "checksum.hpp"
+#include "exporter.hpp"
+#include "parallel.hpp"
+#include "worker.hpp"
+
+namespace cw::exporter
+{
+  using cw::index::Entry;
+
+  // user_data of the no-op close() queues behind everything else, to tell
+  // the completion thread there's nothing more coming.
+  constexpr u64 SENTINEL = ~0ULL;
+  // What acquire() gives back once the export has failed.
+  constexpr u64 NO_SLOT = ~0ULL;
+
+  // An io_uring set up by hand, with no liburing: the submission and
+  // completion rings and the submission entries are mapped in from the
+  // kernel, and shared with it through the head and tail of each ring.
+  struct Exporter::Ring
+  {
+    int fd;
+    void *sq_map, *cq_map, *sqes_map;
+    u64 sq_size, cq_size, sqes_size;
+    u32 *sq_tail, *sq_mask, *sq_array;
+    u32 *cq_head, *cq_tail, *cq_mask;
+    io_uring_sqe *sqes;
+    io_uring_cqe *cqes;
+    bool fixed; // buffers registered, so IORING_OP_WRITE_FIXED
+
+    Ring(void)
+        : fd{-1}, sq_map{MAP_FAILED}, cq_map{MAP_FAILED}, sqes_map{MAP_FAILED},
+          fixed{false}
+    {
+    }
+
+    ~Ring(void)
+    {
+      if (sqes_map != MAP_FAILED)
+        munmap(sqes_map, sqes_size);
+      if (cq_map != MAP_FAILED && cq_map != sq_map)
+        munmap(cq_map, cq_size);
+      if (sq_map != MAP_FAILED)
+        munmap(sq_map, sq_size);
+      if (fd >= 0)
+        ::close(fd); // unregisters the buffers too
+    }
+
+    // Queue one entry, filled in by `fill`, for the next enter().  Callers
+    // hold the exporter's mutex from here until enter() (or unpush()), so
+    // there's never more than the one entry waiting.
+    template <typename F>
+    void push(F &&fill)
+    {
+      const u32 tail    = *sq_tail;
+      const u32 index   = tail & *sq_mask;
+      io_uring_sqe &sqe = sqes[index];
+      memset(&sqe, 0, sizeof(sqe));
+      fill(sqe);
+      sq_array[index] = index;
+      __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    // Take back the last entry pushed, which enter() failed to submit.
+    void unpush(void)
+    {
+      __atomic_store_n(sq_tail, *sq_tail - 1, __ATOMIC_RELEASE);
+    }
+
+    // Submit the entry just pushed.  On failure the kernel hasn't taken it,
+    // and it's still in the ring for unpush().
+    bool enter(void)
+    {
+      while (syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0) < 0)
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+          return false;
+      return true;
+    }
+  };
+
+  static u64 checksum(const BlockHeader &header, const Record *records)
+  {
+    return cw::checksum::bytes(
+        records, header.count * sizeof(Record),
+        (static_cast<u64>(header.magic) << 32) | header.count);
+  }
+
+  static bool write_at(int fd, const void *buffer, u64 size, u64 offset)
+  {
+    const u8 *bytes = static_cast<const u8 *>(buffer);
+    while (size > 0)
+    {
+      ssize_t put = pwrite(fd, bytes, size, offset);
+      if (put < 0 && errno == EINTR)
+        continue;
+      if (put <= 0)
+        return false;
+      bytes += put;
+      size -= put;
+      offset += put;
+    }
+    return true;
+  }
+
+  Exporter::Exporter(void)
+      : fd{-1}, chosen{Backend::PWRITE}, tail{0}, stopping{false},
+        failed{false}
+  {
+  }
+
+  Exporter::~Exporter(void)
+  {
+    close();
+  }
+
+  Backend Exporter::backend(void) const
+  {
+    return chosen;
+  }
+
+  bool Exporter::active(void) const
+  {
+    return fd >= 0;
+  }
+
+  void Exporter::fall_back(const char *why)
+  {
+    if (chosen == Backend::PWRITE)
+      return;
+    chosen = Backend::PWRITE;
+    fprintf(stderr, "export: io_uring %s, using pwrite instead\n", why);
+  }
+
+  bool Exporter::open(const char *path, u64 depth, Backend backend)
+  {
+    assert(fd < 0 && depth > 0);
+    int file = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.endian  = ENDIAN_TAG;
+    header.version = VERSION;
+    if (file < 0 || !write_at(file, &header, sizeof(header), 0))
+    {
+      fprintf(stderr, "export: can't write `%s`: %s\n", path, strerror(errno));
+      if (file >= 0)
+        ::close(file);
+      return false;
+    }
+
+    buffers.assign(depth * EXPORT_BUFFER, 0);
+    slots.assign(depth, Slot{});
+    idle.clear();
+    for (u64 i = depth; i > 0; --i)
+      idle.push_back(i - 1);
+    pending.clear();
+    tail     = sizeof(header);
+    stopping = false;
+    failed   = false;
+    reaping  = false;
+
+    chosen = Backend::PWRITE;
+    if (backend == Backend::URING)
+    {
+      // One entry more than buffers, for close()'s sentinel.
+      ring = setup(depth + 1, buffers.data(), depth);
+      if (ring)
+        chosen = Backend::URING;
+      else
+        fprintf(stderr, "export: no io_uring (%s), using pwrite instead\n",
+                strerror(errno));
+    }
+    fd = file;
+    // The pwrite thread runs either way, to take over if io_uring turns out
+    // not to work after all.
+    writer = std::thread{&Exporter::pwrite_completions, this};
+    if (ring)
+    {
+      reaping     = true;
+      completions = std::thread{&Exporter::uring_completions, this};
+    }
+    return true;
+  }
+
+  u64 Exporter::acquire(void)
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    freed.wait(lock, [this]() { return !idle.empty() || failed; });
+    if (failed)
+      return NO_SLOT;
+    const u64 slot = idle.back();
+    idle.pop_back();
+    return slot;
+  }
+
+  void Exporter::append(const Entry *entries, u64 n)
+  {
+    if (fd < 0)
+      return;
+    while (n > 0)
+    {
+      const u64 slot = acquire();
+      if (slot == NO_SLOT)
+        return;
+
+      // Encoded straight into the buffer the write goes out from.
+      u8 *buffer = buffers.data() + (slot * EXPORT_BUFFER);
+      Record *records =
+          reinterpret_cast<Record *>(buffer + sizeof(BlockHeader));
+      const u64 count = MIN(n, BUFFER_RECORDS);
+      for (u64 i = 0; i < count; ++i)
+        records[i] = Record{entries[i].index(), entries[i].numerator,
+                            entries[i].denominator};
+      BlockHeader header{BLOCK_MAGIC, static_cast<u32>(count), 0};
+      header.checksum = checksum(header, records);
+      memcpy(buffer, &header, sizeof(header));
+
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        Slot &s   = slots[slot];
+        s.offset  = tail;
+        s.bytes   = sizeof(header) + (count * sizeof(Record));
+        s.written = 0;
+        tail += s.bytes;
+      }
+      submit(slot);
+      entries += count;
+      n -= count;
+    }
+  }
+
+  void Exporter::submit(u64 slot)
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (chosen == Backend::URING)
+    {
+      const Slot &s = slots[slot];
+      u8 *buffer    = buffers.data() + (slot * EXPORT_BUFFER);
+      ring->push([&](io_uring_sqe &sqe) {
+        sqe.opcode = ring->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe.fd     = fd;
+        sqe.off    = s.offset + s.written;
+        sqe.addr   = reinterpret_cast<u64>(buffer + s.written);
+        sqe.len    = s.bytes - s.written;
+        if (ring->fixed)
+          sqe.buf_index = slot;
+        sqe.user_data = slot;
+      });
+      if (ring->enter())
+        return;
+      // Left in the ring, the next enter() would write it after all, and
+      // perhaps once the buffer had been reused.
+      ring->unpush();
+      fall_back("can't submit");
+    }
+    pending.push_back(slot);
+    queued.notify_one();
+  }
+
+  void Exporter::complete(u64 slot, i64 result)
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    Slot &s = slots[slot];
+    if (result == -EINTR || result == -EAGAIN)
+      result = 0;
+    else if (result <= 0 && !failed)
+    {
+      failed = true;
+      fprintf(stderr, "export: giving up after a failed write: %s\n",
+              strerror(result < 0 ? -result : EIO));
+    }
+    if (result > 0)
+      s.written += result;
+    if (!failed && s.written < s.bytes)
+    {
+      // Short: the rest goes out from where this one stopped.
+      lock.unlock();
+      submit(slot);
+      return;
+    }
+    idle.push_back(slot);
+    freed.notify_all();
+  }
+
+  void Exporter::uring_completions(void)
+  {
+    for (;;)
+    {
+      const u32 head = *ring->cq_head;
+      if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+      {
+        if (syscall(__NR_io_uring_enter, ring->fd, 0, 1,
+                    IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+            errno != EINTR)
+        {
+          fprintf(stderr, "export: can't wait on io_uring: %s\n",
+                  strerror(errno));
+          std::lock_guard<std::mutex> lock{mutex};
+          failed  = true;
+          reaping = false;
+          freed.notify_all();
+          return;
+        }
+        continue;
+      }
+      const io_uring_cqe cqe = ring->cqes[head & *ring->cq_mask];
+      __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+      if (cqe.user_data == SENTINEL)
+        return;
+      if (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP)
+      {
+        // The kernel has io_uring, but can't write this file with it (or
+        // doesn't know the op): the pwrite thread takes it from here.
+        std::lock_guard<std::mutex> lock{mutex};
+        fall_back("can't write here");
+        pending.push_back(cqe.user_data);
+        queued.notify_one();
+        continue;
+      }
+      complete(cqe.user_data, cqe.res);
+    }
+  }
+
+  void Exporter::pwrite_completions(void)
+  {
+    for (;;)
+    {
+      u64 slot;
+      Slot s;
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        queued.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty())
+          return;
+        slot = pending.front();
+        pending.pop_front();
+        s = slots[slot];
+      }
+      const u8 *buffer = buffers.data() + (slot * EXPORT_BUFFER);
+      const u64 left   = s.bytes - s.written;
+      complete(slot, write_at(fd, buffer + s.written, left,
+                              s.offset + s.written)
+                         ? static_cast<i64>(left)
+                         : -static_cast<i64>(errno));
+    }
+  }
+
+  bool Exporter::close(void)
+  {
+    if (fd < 0)
+      return true;
+    {
+      // Every slot comes back once its write is done, whether it worked or
+      // not, unless nobody's left to reap io_uring's completions: only then
+      // can writes still be in flight when the file and ring go.
+      std::unique_lock<std::mutex> lock{mutex};
+      freed.wait(lock, [this]() {
+        return idle.size() == slots.size() || (ring && !reaping);
+      });
+      stopping = true;
+      queued.notify_all();
+      if (reaping)
+      {
+        // Drained, so it can't complete before anything submitted earlier.
+        ring->push([](io_uring_sqe &sqe) {
+          sqe.opcode    = IORING_OP_NOP;
+          sqe.flags     = IOSQE_IO_DRAIN;
+          sqe.user_data = SENTINEL;
+        });
+        if (!ring->enter())
+          ring->unpush();
+      }
+    }
+    writer.join();
+    if (completions.joinable())
+      completions.join();
+
+    bool ok = !failed && fdatasync(fd) == 0;
+    if (!ok && !failed)
+      fprintf(stderr, "export: can't sync: %s\n", strerror(errno));
+    ok = ::close(fd) == 0 && ok;
+    fd = -1;
+    ring.reset();
+    return ok;
+  }
+
+  // A ring of `entries`, with buffers[0, depth) registered if the kernel
+  // lets us pin them.  nullptr, with errno set, if there's no io_uring.
+  std::unique_ptr<Exporter::Ring> Exporter::setup(u32 entries, u8 *buffers,
+                                                  u64 depth)
+  {
+    io_uring_params params{};
+    const int ring_fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (ring_fd < 0)
+      return nullptr;
+    auto ring = std::make_unique<Exporter::Ring>();
+    ring->fd  = ring_fd;
+
+    ring->sq_size = params.sq_off.array + (params.sq_entries * sizeof(u32));
+    ring->cq_size =
+        params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single)
+      ring->sq_size = ring->cq_size = MAX(ring->sq_size, ring->cq_size);
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+    const int prot = PROT_READ | PROT_WRITE,
+              map  = MAP_SHARED | MAP_POPULATE;
+    ring->sq_map =
+        mmap(nullptr, ring->sq_size, prot, map, ring_fd, IORING_OFF_SQ_RING);
+    ring->cq_map = single ? ring->sq_map
+                          : mmap(nullptr, ring->cq_size, prot, map, ring_fd,
+                                 IORING_OFF_CQ_RING);
+    ring->sqes_map =
+        mmap(nullptr, ring->sqes_size, prot, map, ring_fd, IORING_OFF_SQES);
+    if (ring->sq_map == MAP_FAILED || ring->cq_map == MAP_FAILED ||
+        ring->sqes_map == MAP_FAILED)
+      return nullptr;
+
+    u8 *sq = static_cast<u8 *>(ring->sq_map),
+       *cq = static_cast<u8 *>(ring->cq_map);
+    ring->sq_tail  = reinterpret_cast<u32 *>(sq + params.sq_off.tail);
+    ring->sq_mask  = reinterpret_cast<u32 *>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<u32 *>(sq + params.sq_off.array);
+    ring->cq_head  = reinterpret_cast<u32 *>(cq + params.cq_off.head);
+    ring->cq_tail  = reinterpret_cast<u32 *>(cq + params.cq_off.tail);
+    ring->cq_mask  = reinterpret_cast<u32 *>(cq + params.cq_off.ring_mask);
+    ring->cqes =
+        reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    ring->sqes = static_cast<io_uring_sqe *>(ring->sqes_map);
+
+    // Pinning can fail on a tight RLIMIT_MEMLOCK; plain writes still work.
+    std::vector<iovec> iovecs(depth);
+    for (u64 i = 0; i < depth; ++i)
+      iovecs[i] = iovec{buffers + (i * EXPORT_BUFFER), EXPORT_BUFFER};
+    ring->fixed = syscall(__NR_io_uring_register, ring_fd,
+                          IORING_REGISTER_BUFFERS, iovecs.data(), depth) == 0;
+    return ring;
+  }
+
+  bool bench(const char *path, u64 nodes, u64 depth)
+  {
+    using Clock = std::chrono::steady_clock;
+    using Secs  = std::chrono::duration<f64>;
+
+    bool ok = true;
+    for (Backend backend : {Backend::URING, Backend::PWRITE})
+    {
+      Exporter exporter;
+      if (!exporter.open(path, depth, backend))
+        return false;
+      if (exporter.backend() != backend)
+        continue; // open() has said why
+
+      const auto start = Clock::now();
+      cw::parallel::for_range(0, nodes, [&](u64 begin, u64 end) {
+        cw::index::Run batch;
+        batch.reserve(INDEX_BATCH);
+        cw::node::Fraction value = cw::node::unrank(begin);
+        for (u64 i = begin; i < end; ++i)
+        {
+          batch.push_back({value.numerator, value.denominator,
+                           cw::node::key_of_index(i)});
+          if (batch.size() == INDEX_BATCH)
+          {
+            exporter.append(batch.data(), batch.size());
+            batch.clear();
+          }
+          value = cw::node::next(value);
+        }
+        exporter.append(batch.data(), batch.size());
+      });
+      const auto generated = Clock::now();
+      ok = exporter.close() && ok;
+      const auto written = Clock::now();
+
+      const f64 mib     = nodes * sizeof(Record) / (1024.0 * 1024.0);
+      const f64 elapsed = Secs{written - start}.count();
+      printf("%-6s depth %lu: %lu nodes (%.1f MiB) generated in %.3fs, "
+             "on disk after %.3fs (%.1f MiB/s)\n",
+             backend == Backend::URING ? "uring" : "pwrite", depth, nodes, mib,
+             Secs{generated - start}.count(), elapsed, mib / elapsed);
+    }
+    return ok;
+  }
+} // namespace cw::exporter
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
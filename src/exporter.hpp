@@ -0,0 +1,160 @@
+/* exporter.hpp: Streaming generated nodes out to a file, asynchronously
+ * Created: 2026-10-19
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef EXPORTER_HPP
+#define EXPORTER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base.hpp"
+#include "index.hpp"
+
+#ifndef EXPORT_BUFFER
+#define EXPORT_BUFFER (1 << 16)
+#endif
+
+#ifndef EXPORT_DEPTH
+#define EXPORT_DEPTH 32
+#endif
+
+namespace cw::exporter
+{
+  // An export is every node as it's generated, in whatever order workers
+  // hand them over:
+  //
+  //   Header | Block*
+  //
+  // Each Block is a BlockHeader then Record[count], with a checksum over
+  // the records like a journal block's.  A block is the contents of one
+  // buffer, and blocks land in the order their writes were queued, so a
+  // crash can leave a torn or missing block anywhere after the last one
+  // written: readers should stop at the first that doesn't add up.  Written
+  // raw, so only good on a host with the same byte order.
+  constexpr char MAGIC[8]   = {'C', 'W', 'T', 'R', 'E', 'E', 'E', 'X'};
+  constexpr u32 VERSION     = 1;
+  constexpr u32 ENDIAN_TAG  = 0x01020304;
+  constexpr u32 BLOCK_MAGIC = 0x42455743; // "CWEB"
+
+  struct Header
+  {
+    char magic[8];
+    u32 endian, version;
+  };
+
+  struct BlockHeader
+  {
+    u32 magic, count;
+    u64 checksum;
+  };
+
+  struct Record
+  {
+    u64 index, numerator, denominator;
+  };
+
+  // Records that fit in a buffer behind its BlockHeader.
+  constexpr u64 BUFFER_RECORDS =
+      (EXPORT_BUFFER - sizeof(BlockHeader)) / sizeof(Record);
+
+  enum class Backend
+  {
+    // Buffers registered with an io_uring once, then written with
+    // IORING_OP_WRITE_FIXED: the kernel doesn't have to map them each time.
+    URING,
+    // A thread of our own doing pwrite, for kernels without io_uring (or
+    // where it's been turned off), or files it can't write.
+    PWRITE,
+  };
+
+  // Workers encode their batches straight into one of `depth` buffers of
+  // EXPORT_BUFFER bytes, reserve its place at the end of the file, and
+  // queue the write.  They only wait on the disk if every buffer is still
+  // being written.  A completion thread hands buffers back as their writes
+  // finish, so they're reused rather than allocated per batch.
+  struct Exporter
+  {
+    Exporter(void);
+    ~Exporter(void);
+
+    // Start a new export at `path`, truncating anything there, with `depth`
+    // buffers.  Uses io_uring if `backend` is URING and the kernel has it,
+    // else falls back to PWRITE.  Prints why and returns false on failure.
+    bool open(const char *path, u64 depth, Backend backend = Backend::URING);
+
+    // Queue entries[0, n) to be written, a buffer at a time.  Does nothing
+    // if the export isn't open, or has failed to write (which it reports
+    // once).
+    void append(const cw::index::Entry *entries, u64 n);
+
+    // Wait for every write queued so far, sync and close the file.  False
+    // if any write failed.  No appends may be running.
+    bool close(void);
+
+    // What's writing: what open() ended up with, unless io_uring has since
+    // failed and it's fallen back to PWRITE.
+    Backend backend(void) const;
+
+    // Whether it's open, so appends go anywhere.
+    bool active(void) const;
+
+  private:
+    struct Ring;
+    struct Slot
+    {
+      u64 offset, bytes, written;
+    };
+
+    static std::unique_ptr<Ring> setup(u32 entries, u8 *buffers, u64 depth);
+    u64 acquire(void);
+    void submit(u64 slot);
+    void complete(u64 slot, i64 result);
+    void fall_back(const char *why); // with the mutex held
+    void uring_completions(void);
+    void pwrite_completions(void);
+
+    int fd;
+    std::atomic<Backend> chosen; // only changed with the mutex held
+    std::unique_ptr<Ring> ring;
+    std::vector<u8> buffers; // `depth` of EXPORT_BUFFER bytes
+    std::vector<Slot> slots;
+    std::mutex mutex;
+    std::condition_variable freed, queued;
+    std::vector<u64> idle;   // slots nobody's filling or writing
+    std::deque<u64> pending; // slots for the pwrite thread
+    u64 tail;                // end of the file once queued writes are done
+    bool stopping, failed;
+    bool reaping; // the io_uring completion thread is still running
+    std::thread completions, writer; // for io_uring, and pwrite
+  };
+
+  // Time generating `nodes` nodes on a thread per core into an export at
+  // `path` with each backend in turn: both how long the generating threads
+  // took, which is all they'd be held up by, and how long until everything
+  // was on disk.  Prints the results; false if either export failed.
+  bool bench(const char *path, u64 nodes, u64 depth);
+} // namespace cw::exporter
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
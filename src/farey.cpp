@@ -0,0 +1,82 @@
+/* farey.cpp: How much of each Farey sequence has been generated
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <numeric>
+
+#include "farey.hpp"
+
+namespace cw::farey
+{
+  Coverage::Coverage(void)
+      : totient(FAREY_MAX_DENOMINATOR + 1),
+        hits{new std::atomic<u64>[FAREY_MAX_DENOMINATOR + 1]},
+        last{new std::atomic<u64>[FAREY_MAX_DENOMINATOR + 1]}
+  {
+    // Sieve for phi.
+    std::iota(totient.begin(), totient.end(), 0);
+    for (u64 q = 2; q <= FAREY_MAX_DENOMINATOR; ++q)
+      if (totient[q] == q)
+        for (u64 multiple = q; multiple <= FAREY_MAX_DENOMINATOR;
+             multiple += q)
+          totient[multiple] -= totient[multiple] / q;
+
+    for (u64 q = 0; q <= FAREY_MAX_DENOMINATOR; ++q)
+    {
+      hits[q].store(0, std::memory_order_relaxed);
+      last[q].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void Coverage::record(u64 p, u64 q, u64 index)
+  {
+    if (q > FAREY_MAX_DENOMINATOR || p > q)
+      return;
+    // Raise last before counting the hit, so whoever sees the final hit also
+    // sees the final last.
+    u64 seen = last[q].load(std::memory_order_relaxed);
+    while (seen < index && !last[q].compare_exchange_weak(
+                               seen, index, std::memory_order_relaxed))
+      continue;
+    hits[q].fetch_add(1, std::memory_order_release);
+  }
+
+  u64 Coverage::complete_to(void) const
+  {
+    u64 q = 1;
+    while (q <= FAREY_MAX_DENOMINATOR &&
+           hits[q].load(std::memory_order_acquire) == totient[q])
+      ++q;
+    return q - 1;
+  }
+
+  std::vector<u64> Coverage::completion(void) const
+  {
+    std::vector<u64> counts;
+    u64 latest = 0;
+    for (u64 q = 1; q <= FAREY_MAX_DENOMINATOR &&
+                    hits[q].load(std::memory_order_acquire) == totient[q];
+         ++q)
+    {
+      latest = MAX(latest, last[q].load(std::memory_order_relaxed) + 1);
+      counts.push_back(latest);
+    }
+    return counts;
+  }
+} // namespace cw::farey
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
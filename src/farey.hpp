@@ -0,0 +1,64 @@
+/* farey.hpp: How much of each Farey sequence has been generated
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef FAREY_HPP
+#define FAREY_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base.hpp"
+
+#ifndef FAREY_MAX_DENOMINATOR
+#define FAREY_MAX_DENOMINATOR (1 << 12)
+#endif
+
+namespace cw::farey
+{
+  // Tracks, for each Q up to FAREY_MAX_DENOMINATOR, the node count at which
+  // every fraction of the Farey sequence F_Q in (0, 1] (reduced p/q with p <=
+  // q <= Q) has been generated.  Every positive rational turns up in the tree
+  // exactly once, so a count per denominator is enough to know when all
+  // phi(q) of them have.  Recording a fraction is a couple of atomic
+  // operations on its denominator's counters, and nothing at all for the
+  // rest, so workers can call it from the hot path.
+  struct Coverage
+  {
+    Coverage(void);
+
+    // Fraction p/q has been generated at BFS index `index`.
+    void record(u64 p, u64 q, u64 index);
+
+    // Largest Q for which F_Q has been generated, or 0.
+    u64 complete_to(void) const;
+
+    // Node count at which F_Q was complete, for Q in [1, complete_to()].
+    std::vector<u64> completion(void) const;
+
+  private:
+    std::vector<u64> totient; // phi(q), the size of F_q less F_(q - 1)
+    // Per denominator: how many have been generated, and the largest BFS
+    // index among them.
+    std::unique_ptr<std::atomic<u64>[]> hits, last;
+  };
+} // namespace cw::farey
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,77 @@
+/* format.cpp: Numbers, fractions and paths as text, without allocating
+ * Created: 2026-10-19
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <cstring>
+
+#include "format.hpp"
+
+namespace cw::format
+{
+  using cw::node::Fraction;
+
+  // "00" "01" ... "99", so we can emit two digits per division.
+  static const char DIGIT_PAIRS[201] =
+      "0001020304050607080910111213141516171819202122232425262728293031323334"
+      "3536373839404142434445464748495051525354555657585960616263646566676869"
+      "707172737475767778798081828384858687888990919293949596979899";
+
+  char *format_u64(char *out, u64 n)
+  {
+    // Fill from the back of a scratch buffer, then copy forward.
+    char buffer[U64_DIGITS];
+    char *ptr = buffer + U64_DIGITS;
+    while (n >= 100)
+    {
+      u64 pair = (n % 100) * 2;
+      n /= 100;
+      *--ptr = DIGIT_PAIRS[pair + 1];
+      *--ptr = DIGIT_PAIRS[pair];
+    }
+    if (n >= 10)
+    {
+      *--ptr = DIGIT_PAIRS[(n * 2) + 1];
+      *--ptr = DIGIT_PAIRS[n * 2];
+    }
+    else
+      *--ptr = '0' + n;
+
+    u64 length = (buffer + U64_DIGITS) - ptr;
+    memcpy(out, ptr, length);
+    return out + length;
+  }
+
+  char *format_fraction(char *out, const Fraction &f)
+  {
+    out    = format_u64(out, f.numerator);
+    *out++ = '/';
+    out    = format_u64(out, f.denominator);
+    *out   = '\0';
+    return out;
+  }
+
+  char *format_path(char *out, u64 index)
+  {
+    u64 path = index + 1;
+    for (int bit = cw::node::depth(index) - 1; bit >= 0; --bit)
+      *out++ = (path & (1ULL << bit)) ? 'R' : 'L';
+    *out = '\0';
+    return out;
+  }
+} // namespace cw::format
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,48 @@
+/* format.hpp: Numbers, fractions and paths as text, without allocating
+ * Created: 2026-10-19
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef FORMAT_HPP
+#define FORMAT_HPP
+
+#include "base.hpp"
+#include "node.hpp"
+
+namespace cw::format
+{
+  // Longest u64 is 20 digits.
+  constexpr u64 U64_DIGITS = 20;
+
+  // Write the decimal digits of n to out (no terminator), returning one past
+  // the last digit written.  out must have room for U64_DIGITS characters.
+  char *format_u64(char *out, u64 n);
+
+  // Write "numerator/denominator" to out, null terminated, returning a
+  // pointer to the terminator.  out must have room for FRACTION_SIZE
+  // characters.
+  constexpr u64 FRACTION_SIZE = (2 * U64_DIGITS) + 2;
+  char *format_fraction(char *out, const cw::node::Fraction &);
+
+  // Write the path from the root to the node at BFS index `index` as L and R
+  // steps, null terminated, returning a pointer to the terminator.  out must
+  // have room for 64 characters.
+  char *format_path(char *out, u64 index);
+} // namespace cw::format
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
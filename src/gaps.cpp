@@ -0,0 +1,106 @@
+/* gaps.cpp: Gaps between generated fractions on the number line
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "gaps.hpp"
+
+namespace cw::gaps
+{
+  static u64 bucket(f64 length)
+  {
+    i64 b = -std::ilogb(length);
+    return b < 0 ? 0 : MIN(static_cast<u64>(b), HISTOGRAM_BUCKETS - 1);
+  }
+
+  Tracker::Tracker(void) : counts{}
+  {
+    // 0 is where the number line starts, though it's never generated.
+    values.emplace(0, 0.0);
+  }
+
+  void Tracker::add(const Gap &gap)
+  {
+    heap.push(gap);
+    ++counts[bucket(gap.length)];
+  }
+
+  void Tracker::insert(u64 key, f64 norm)
+  {
+    auto [it, inserted] = values.emplace(key, norm);
+    if (!inserted)
+      return;
+
+    // Keys are never 0, so there's always something to the left.
+    auto left = std::prev(it), right = std::next(it);
+    if (right != values.end())
+      --counts[bucket(right->second - left->second)];
+    add(Gap{norm - left->second, left->first, key});
+    if (right != values.end())
+      add(Gap{right->second - norm, key, right->first});
+  }
+
+  void Tracker::insert(const cw::index::Entry *entries, u64 n)
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    for (u64 i = 0; i < n; ++i)
+      insert(entries[i].key, entries[i].norm());
+    // Every split leaves a stale gap behind, so without this the heap would
+    // grow to about three times the number of gaps.
+    const u64 live = values.size() - 1;
+    if (heap.size() - live > live)
+      rebuild();
+  }
+
+  void Tracker::rebuild(void)
+  {
+    std::vector<Gap> gaps;
+    gaps.reserve(values.size() - 1);
+    for (auto left = values.begin(), right = std::next(left);
+         right != values.end(); left = right++)
+      gaps.push_back(
+          Gap{right->second - left->second, left->first, right->first});
+    heap = std::priority_queue<Gap>{std::less<Gap>{}, std::move(gaps)};
+  }
+
+  std::optional<Gap> Tracker::max_gap(void)
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    while (!heap.empty())
+    {
+      // A gap is still there iff its ends are still neighbours.
+      const Gap &top = heap.top();
+      auto left      = values.find(top.left);
+      if (std::next(left) != values.end() && std::next(left)->first == top.right)
+        return top;
+      heap.pop();
+    }
+    return std::nullopt;
+  }
+
+  Histogram Tracker::histogram(void) const
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    return counts;
+  }
+} // namespace cw::gaps
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
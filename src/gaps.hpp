@@ -0,0 +1,88 @@
+/* gaps.hpp: Gaps between generated fractions on the number line
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef GAPS_HPP
+#define GAPS_HPP
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <queue>
+
+#include "base.hpp"
+#include "index.hpp"
+
+namespace cw::gaps
+{
+  // Space between two neighbouring fractions, identified by their order keys.
+  struct Gap
+  {
+    f64 length;
+    u64 left, right;
+
+    bool operator<(const Gap &other) const
+    {
+      return length < other.length;
+    }
+  };
+
+  // Bucket b counts gaps of length in [2^-b, 2^(1 - b)), with the ends
+  // catching everything beyond.
+  constexpr u64 HISTOGRAM_BUCKETS = 64;
+  using Histogram                 = std::array<u64, HISTOGRAM_BUCKETS>;
+
+  // How the generated fractions fill [0, upper]: every fraction in value
+  // order (with 0 at the start), a max-heap of the gaps between neighbours
+  // and a histogram of their lengths.  Each insert splits one gap in two.
+  // The heap isn't told about the gap that went away; stale gaps are thrown
+  // out when they reach the top instead, and the heap is rebuilt from the
+  // fractions whenever stale gaps outnumber live ones.  O(log n) per
+  // fraction, amortised.
+  //
+  // The fractions are kept here rather than looked up in the value index,
+  // as the index merges batches lazily: a new fraction's neighbours may not
+  // be in it yet.
+  struct Tracker
+  {
+    Tracker(void);
+
+    // Add a batch of fractions, under one lock: workers hand over each
+    // batch as they flush it to the value index, not each node.
+    void insert(const cw::index::Entry *entries, u64 n);
+
+    // Largest gap, if anything has been inserted.
+    std::optional<Gap> max_gap(void);
+
+    Histogram histogram(void) const;
+
+  private:
+    mutable std::mutex mutex;
+    std::map<u64, f64> values; // order key to value
+    std::priority_queue<Gap> heap;
+    Histogram counts;
+
+    void insert(u64 key, f64 norm);
+    void add(const Gap &);
+    void rebuild(void);
+  };
+} // namespace cw::gaps
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
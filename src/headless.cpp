@@ -0,0 +1,154 @@
+/* headless.cpp: Rendering frames without a window
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "draw.hpp"
+#include "headless.hpp"
+
+namespace cw::headless
+{
+  using cw::options::FrameFormat;
+  using cw::options::Options;
+  using cw::snapshot::Pipeline;
+  using cw::state::DrawState;
+
+  constexpr auto POLL_DELAY = std::chrono::milliseconds(10);
+
+  static volatile std::sig_atomic_t interrupted = 0;
+
+  static void on_signal(int)
+  {
+    interrupted = 1;
+  }
+
+  static bool write_ppm(const Image &image, const char *path)
+  {
+    FILE *fp = fopen(path, "wb");
+    if (!fp)
+      return false;
+    fprintf(fp, "P6\n%d %d\n255\n", image.width, image.height);
+    const u8 *pixels = static_cast<const u8 *>(image.data);
+    std::vector<u8> row(3 * image.width);
+    for (int y = 0; y < image.height; ++y)
+    {
+      const u8 *rgba = pixels + (4 * y * image.width);
+      for (int x = 0; x < image.width; ++x)
+      {
+        row[3 * x]       = rgba[4 * x];
+        row[(3 * x) + 1] = rgba[(4 * x) + 1];
+        row[(3 * x) + 2] = rgba[(4 * x) + 2];
+      }
+      fwrite(row.data(), 1, row.size(), fp);
+    }
+    return fclose(fp) == 0;
+  }
+
+  void run(Pipeline &pipeline, const Options &options)
+  {
+    interrupted = 0;
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    DrawState draw_state;
+    draw_state.colouring = options.colouring;
+    cw::draw::Geometry geometry;
+    cw::draw::NumberLine number_line;
+    cw::draw::Graph graph;
+    std::vector<cw::node::Located> found;
+    cw::draw::Camera camera = cw::draw::default_camera();
+    Image image             = GenImageColor(WIDTH, HEIGHT, BLACK);
+
+    u64 next_frame = options.frame_every, frame = 0;
+    char path[4096];
+
+    while (!interrupted)
+    {
+      std::this_thread::sleep_for(POLL_DELAY);
+
+      pipeline.acquire();
+      const cw::snapshot::Frame &snapshot = pipeline.front();
+      u64 count = snapshot.count();
+      bool done = options.max_nodes > 0 && count >= options.max_nodes;
+      if (done)
+        count = options.max_nodes;
+      else if (count < next_frame)
+        continue;
+      next_frame = count + options.frame_every;
+
+      draw_state.compute_bounds(count);
+      const cw::draw::Geometry *drawn = &geometry;
+      switch (options.view)
+      {
+      case DrawState::View::NUMBER_LINE:
+        number_line.update(snapshot.norms.data(), count, draw_state,
+                           camera.origin);
+        drawn = &number_line.geometry;
+        break;
+      case DrawState::View::GRAPH:
+        graph.update(cw::draw::viewport(camera, WIDTH, HEIGHT), WIDTH, count,
+                     draw_state, 2 * WIDTH, camera.origin);
+        drawn = &graph.geometry;
+        break;
+      case DrawState::View::DEEP_ZOOM:
+        cw::draw::build_deep_zoom(geometry, found,
+                                  cw::draw::viewport(camera, WIDTH, HEIGHT),
+                                  draw_state, camera.origin);
+        break;
+      }
+
+      ImageClearBackground(&image, BLACK);
+      cw::draw::rasterise(*drawn, image, camera.relative(), CIRCLE_SIZE);
+
+      bool written = false;
+      switch (options.frame_format)
+      {
+      case FrameFormat::PNG:
+        snprintf(path, sizeof(path), "%s/frame_%06lu.png",
+                 options.frames_dir.c_str(), frame);
+        written = ExportImage(image, path);
+        break;
+      case FrameFormat::PPM:
+        snprintf(path, sizeof(path), "%s/frame_%06lu.ppm",
+                 options.frames_dir.c_str(), frame);
+        written = write_ppm(image, path);
+        break;
+      }
+      if (!written)
+      {
+        fprintf(stderr, "[headless]: could not write `%s`\n", path);
+        break;
+      }
+      printf("[headless]: frame %lu (%lu nodes) -> %s\n", frame, count, path);
+      ++frame;
+
+      if (done)
+        break;
+    }
+
+    UnloadImage(image);
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+  }
+} // namespace cw::headless
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,38 @@
+/* headless.hpp: Rendering frames without a window
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef HEADLESS_HPP
+#define HEADLESS_HPP
+
+#include "options.hpp"
+#include "snapshot.hpp"
+
+namespace cw::headless
+{
+  // Render the chosen view into a CPU side image every options.frame_every
+  // nodes and write it out to options.frames_dir, until options.max_nodes is
+  // reached or we're interrupted (SIGINT/SIGTERM).  Never touches the window
+  // or GL, so works on machines without a display.
+  // Frames are drawn from the pipeline, never from the tree itself.
+  void run(cw::snapshot::Pipeline &pipeline,
+           const cw::options::Options &options);
+} // namespace cw::headless
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
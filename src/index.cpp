@@ -0,0 +1,230 @@
+/* index.cpp: Indices over generated nodes
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "index.hpp"
+#include "radix.hpp"
+
+namespace cw::index
+{
+  u64 Version::size(void) const
+  {
+    u64 total = 0;
+    for (const auto &level : runs)
+      total += level->entries.size();
+    return total;
+  }
+
+  // Find where x goes in each run, calling visit(run, position) with the
+  // first position whose entry isn't before(norm), from the last run to the
+  // first.  Everything in a level's cascade ahead of where x goes is before
+  // it, and nothing after, so the samples either side of that point bound
+  // where x goes in the level before to less than a stride.
+  template <typename Before, typename Visit>
+  static void cascade(const std::vector<std::shared_ptr<const Level>> &runs,
+                      Before before, Visit visit)
+  {
+    // First position in [lo, hi) of `level` that isn't before.
+    auto search = [&](const Level &level, u64 lo, u64 hi) {
+      while (lo < hi)
+      {
+        u64 mid = lo + ((hi - lo) / 2);
+        if (before(level.norm(mid)))
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      return lo;
+    };
+
+    if (runs.empty())
+      return;
+    u64 at = search(*runs.back(), 0, runs.back()->size());
+    for (u64 k = runs.size() - 1;; --k)
+    {
+      const Level &level = *runs[k];
+      if (k == 0)
+      {
+        visit(level.entries, at);
+        return;
+      }
+      const Bridge &bridge = level.cascade[at];
+      visit(level.entries, bridge.own);
+      const u64 hi = bridge.next;
+      const u64 lo =
+          hi == 0 ? 0 : (((hi - 1) / level.stride) * level.stride) + 1;
+      at = search(*runs[k - 1], lo, hi);
+    }
+  }
+
+  const Entry *Version::nearest(f64 x) const
+  {
+    const Entry *best = nullptr;
+    f64 best_dist     = INFINITY;
+    auto consider     = [&](const Entry &entry) {
+      if (std::abs(entry.norm() - x) < best_dist)
+      {
+        best      = &entry;
+        best_dist = std::abs(entry.norm() - x);
+      }
+    };
+    // First entry in each run with value >= x; the nearest is it or the one
+    // before it.
+    cascade(
+        runs, [x](f64 norm) { return norm < x; },
+        [&](const Run &run, u64 at) {
+          if (at < run.size())
+            consider(run[at]);
+          if (at > 0)
+            consider(run[at - 1]);
+        });
+    return best;
+  }
+
+  const Entry *Version::above(f64 x) const
+  {
+    const Entry *best = nullptr;
+    cascade(
+        runs, [x](f64 norm) { return norm <= x; },
+        [&](const Run &run, u64 at) {
+          if (at < run.size() && (!best || run[at] < *best))
+            best = &run[at];
+        });
+    return best;
+  }
+
+  // Level for `run`, following `prev` (or first, if there's none).  Linear
+  // in the size of the run, like the merge that made it, so entries still
+  // cost O(log n) each to index.
+  static std::shared_ptr<const Level> make_level(Run run, const Level *prev)
+  {
+    auto level     = std::make_shared<Level>();
+    level->entries = std::move(run);
+    level->stride  = 0;
+    if (!prev)
+      return level;
+
+    // Sample about as many as there are entries, and at least every other
+    // one, so the cascade is at most twice the size of the run.
+    const Run &entries = level->entries;
+    const u64 before   = prev->size();
+    const u64 stride =
+        MAX(2, (before + entries.size() - 1) / entries.size());
+    const u64 samples = (before + stride - 1) / stride;
+    level->stride     = stride;
+
+    // Norms are a division each, so work them out up front (where they
+    // vectorise), each list ending in INFINITY so the merge below needn't
+    // check either is used up.
+    std::vector<f64> own_norms(entries.size() + 1), sample_norms(samples + 1);
+    for (u64 i = 0; i < entries.size(); ++i)
+      own_norms[i] = entries[i].norm();
+    for (u64 i = 0; i < samples; ++i)
+      sample_norms[i] = prev->norm(i * stride);
+    own_norms.back()    = INFINITY;
+    sample_norms.back() = INFINITY;
+
+    // Which side comes next is a coin toss, so merge without branching on it.
+    level->cascade.resize(entries.size() + samples + 1);
+    u64 own = 0, sample = 0;
+    for (Bridge &bridge : level->cascade)
+    {
+      const bool take_sample = sample_norms[sample] <= own_norms[own];
+      bridge = Bridge{take_sample ? sample_norms[sample] : own_norms[own], own,
+                      MIN(sample * stride, before)};
+      sample += take_sample;
+      own += !take_sample;
+    }
+    level->cascade.back() = Bridge{INFINITY, own, before};
+    return level;
+  }
+
+  OrderedIndex::OrderedIndex(void) : current{std::make_shared<const Version>()}
+  {
+  }
+
+  // Add a sorted run to the back of `runs`, merging it into the smaller runs
+  // there while they're less than twice what we've got, so sizes still at
+  // least halve whatever size the batches come in.  A run merged from the
+  // back grows by at least half each time, and the new run only goes
+  // through as many merges as there are runs, so each entry is still merged
+  // O(log n) times.
+  static void add_run(std::vector<std::shared_ptr<const Level>> &runs,
+                      Run run)
+  {
+    while (!runs.empty() && runs.back()->entries.size() < 2 * run.size())
+    {
+      const Run &prev = runs.back()->entries;
+      Run merged(prev.size() + run.size());
+      std::merge(prev.begin(), prev.end(), run.begin(), run.end(),
+                 merged.begin());
+      run = std::move(merged);
+      runs.pop_back();
+    }
+    runs.push_back(
+        make_level(std::move(run), runs.empty() ? nullptr : runs.back().get()));
+  }
+
+  void OrderedIndex::insert(Run &&batch)
+  {
+    if (batch.empty())
+      return;
+    Run scratch(batch.size());
+    cw::radix::sort(batch.data(), scratch.data(), batch.size(),
+                    [](const Entry &entry) { return entry.key; });
+    {
+      std::lock_guard<std::mutex> lock{pending_mutex};
+      pending.push_back(std::move(batch));
+    }
+
+    // Whoever holds merge_mutex picks up everything pending, so if it's
+    // taken our batch is in good hands.  Check again after letting go, in
+    // case a batch arrived just as we finished.
+    std::vector<Run> taken;
+    while (merge_mutex.try_lock())
+    {
+      {
+        std::lock_guard<std::mutex> lock{pending_mutex};
+        taken.swap(pending);
+      }
+      if (!taken.empty())
+      {
+        auto next = std::make_shared<Version>(*std::atomic_load(&current));
+        for (auto &run : taken)
+          add_run(next->runs, std::move(run));
+        taken.clear();
+        std::atomic_store(&current,
+                          std::shared_ptr<const Version>{std::move(next)});
+      }
+      merge_mutex.unlock();
+
+      std::lock_guard<std::mutex> lock{pending_mutex};
+      if (pending.empty())
+        break;
+    }
+  }
+
+  std::shared_ptr<const Version> OrderedIndex::latest(void) const
+  {
+    return std::atomic_load(&current);
+  }
+} // namespace cw::index
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
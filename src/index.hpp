@@ -0,0 +1,137 @@
+/* index.hpp: Indices over generated nodes
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef INDEX_HPP
+#define INDEX_HPP
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "base.hpp"
+#include "node.hpp"
+
+namespace cw::index
+{
+  // A generated node, by value.
+  struct Entry
+  {
+    u64 numerator, denominator;
+    u64 key; // cw::node::key_of_index of the node
+
+    u64 index(void) const
+    {
+      return cw::node::index_of_key(key);
+    }
+
+    f64 norm(void) const
+    {
+      return static_cast<f64>(numerator) / denominator;
+    }
+  };
+
+  // Exact order by value, with no arithmetic on the fractions.
+  inline bool operator<(const Entry &a, const Entry &b)
+  {
+    return a.key < b.key;
+  }
+
+  // Entries sorted by value.
+  using Run = std::vector<Entry>;
+
+  // One element of a level's cascade: an entry of its run or a sample of the
+  // level before's cascade, in value order.
+  struct Bridge
+  {
+    f64 norm;
+    u64 own;  // how many of the run's entries come before it
+    u64 next; // first sample of the level before at or after it
+  };
+
+  // A sorted run, and what it takes to carry a search of the level before
+  // over to it (fractional cascading).  The cascade is the run merged with
+  // every stride-th element of the level before's cascade (or run, for the
+  // first level, which has no cascade), with one past-the-end Bridge.  The
+  // stride keeps the cascade at most twice the size of the run, and since
+  // runs only change at the back, the levels before a run never change while
+  // it's in use: levels are built once and shared between versions.
+  struct Level
+  {
+    Run entries;
+    std::vector<Bridge> cascade;
+    u64 stride;
+
+    // Elements to search: the cascade, or the run for the first level.
+    u64 size(void) const
+    {
+      return cascade.empty() ? entries.size() : cascade.size() - 1;
+    }
+
+    f64 norm(u64 i) const
+    {
+      return cascade.empty() ? entries[i].norm() : cascade[i].norm;
+    }
+  };
+
+  // The index as of some moment: a few immutable sorted runs whose sizes at
+  // least halve from one to the next (like a binary counter).  Never changes
+  // once published, so any number of readers can share it without a lock,
+  // and levels are shared between versions rather than copied.
+  struct Version
+  {
+    std::vector<std::shared_ptr<const Level>> runs;
+
+    u64 size(void) const;
+
+    // Entry whose value is nearest to x, or nullptr if empty.  One binary
+    // search of the last level's cascade, then a search of at most a stride
+    // for each level before it.  Strides are about the ratio of one run to
+    // the next, so those searches telescope to O(log n) overall.
+    const Entry *nearest(f64 x) const;
+
+    // Entry with the least value above x, or nullptr if there's none.  Also
+    // O(log n).
+    const Entry *above(f64 x) const;
+  };
+
+  // Every node in value order, fed in batches by the workers as they
+  // generate them.  Each inserter sorts its own batch on its own thread; the
+  // merge into the runs is done by whichever inserter gets there first, and
+  // anyone who finds it busy leaves their batch for it rather than waiting.
+  // Each node is merged O(log n) times over its life.
+  struct OrderedIndex
+  {
+    OrderedIndex(void);
+
+    void insert(Run &&batch);
+
+    // The latest version.  One shared_ptr copy, which never waits on
+    // inserters.
+    std::shared_ptr<const Version> latest(void) const;
+
+  private:
+    std::mutex pending_mutex, merge_mutex;
+    std::vector<Run> pending; // sorted batches yet to be merged
+    // Only accessed through std::atomic_load and std::atomic_store.
+    std::shared_ptr<const Version> current;
+  };
+} // namespace cw::index
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,206 @@
+/* journal.cpp: Append-only log of generated nodes between checkpoints
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checksum.hpp"
+#include "journal.hpp"
+
+namespace cw::journal
+{
+  using cw::index::Entry;
+
+  static_assert(std::is_trivially_copyable<Entry>::value,
+                "Entries are journalled as raw bytes");
+
+  u64 checksum(const BlockHeader &header, const Entry *entries)
+  {
+    // Chained, so reordered entries change it as well as flipped bits.
+    using cw::checksum::mix;
+    u64 sum = mix((static_cast<u64>(header.magic) << 32) | header.count);
+    for (u64 i = 0; i < header.count; ++i)
+    {
+      sum = mix(sum ^ entries[i].numerator);
+      sum = mix(sum ^ entries[i].denominator);
+      sum = mix(sum ^ entries[i].key);
+    }
+    return sum;
+  }
+
+  Journal::Journal(void)
+      : fd{-1}, tickets{0}, durable{0}, writing{false}, failed{false}
+  {
+  }
+
+  Journal::~Journal(void)
+  {
+    if (fd >= 0)
+      close(fd);
+  }
+
+  static bool read_at(int fd, void *buffer, u64 size, u64 offset)
+  {
+    u8 *bytes = static_cast<u8 *>(buffer);
+    while (size > 0)
+    {
+      ssize_t got = pread(fd, bytes, size, offset);
+      if (got < 0 && errno == EINTR)
+        continue;
+      if (got <= 0)
+        return false;
+      bytes += got;
+      size -= got;
+      offset += got;
+    }
+    return true;
+  }
+
+  static bool write_full(int fd, const u8 *bytes, u64 size)
+  {
+    while (size > 0)
+    {
+      ssize_t put = write(fd, bytes, size);
+      if (put < 0 && errno == EINTR)
+        continue;
+      if (put <= 0)
+        return false;
+      bytes += put;
+      size -= put;
+    }
+    return true;
+  }
+
+  bool Journal::open(const char *path, cw::index::Run &replayed)
+  {
+    int file = ::open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    struct stat info;
+    if (file < 0 || fstat(file, &info) != 0)
+    {
+      fprintf(stderr, "journal: can't open `%s`: %s\n", path, strerror(errno));
+      if (file >= 0)
+        close(file);
+      return false;
+    }
+
+    // Every block up to the first that's torn or doesn't add up.
+    const u64 size = info.st_size;
+    u64 offset     = 0;
+    BlockHeader header;
+    while (offset + sizeof(header) <= size &&
+           read_at(file, &header, sizeof(header), offset) &&
+           header.magic == BLOCK_MAGIC &&
+           header.count <= (size - offset - sizeof(header)) / sizeof(Entry))
+    {
+      const u64 start = replayed.size();
+      replayed.resize(start + header.count);
+      if (!read_at(file, replayed.data() + start,
+                   header.count * sizeof(Entry), offset + sizeof(header)) ||
+          checksum(header, replayed.data() + start) != header.checksum)
+      {
+        replayed.resize(start);
+        break;
+      }
+      offset += sizeof(header) + (header.count * sizeof(Entry));
+    }
+
+    if (offset < size)
+    {
+      fprintf(stderr, "journal: `%s`: dropping %lu bytes after the last "
+                      "intact block\n",
+              path, size - offset);
+      if (ftruncate(file, offset) != 0)
+      {
+        fprintf(stderr, "journal: can't truncate `%s`: %s\n", path,
+                strerror(errno));
+        close(file);
+        return false;
+      }
+    }
+    fd = file;
+    return true;
+  }
+
+  void Journal::append(const Entry *entries, u64 n)
+  {
+    if (fd < 0 || n == 0)
+      return;
+    assert(n <= UINT32_MAX);
+    BlockHeader header{BLOCK_MAGIC, static_cast<u32>(n), 0};
+    header.checksum = checksum(header, entries);
+
+    std::unique_lock<std::mutex> lock{mutex};
+    if (failed)
+      return;
+    const u8 *bytes = reinterpret_cast<const u8 *>(&header);
+    queued.insert(queued.end(), bytes, bytes + sizeof(header));
+    bytes = reinterpret_cast<const u8 *>(entries);
+    queued.insert(queued.end(), bytes, bytes + (n * sizeof(Entry)));
+    const u64 ticket = ++tickets;
+
+    while (durable < ticket && !failed)
+    {
+      if (writing)
+      {
+        committed.wait(lock);
+        continue;
+      }
+      // Nobody's writing, so we lead: everything queued so far, ours
+      // included, goes out in one write and one sync.
+      writing = true;
+      std::vector<u8> group;
+      group.swap(queued);
+      const u64 upto = tickets;
+      lock.unlock();
+      bool ok = write_full(fd, group.data(), group.size()) &&
+                fdatasync(fd) == 0;
+      lock.lock();
+      writing = false;
+      if (ok)
+        durable = upto;
+      else
+      {
+        failed = true;
+        fprintf(stderr, "journal: giving up after a failed write: %s\n",
+                strerror(errno));
+      }
+      committed.notify_all();
+    }
+  }
+
+  void Journal::reset(void)
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (fd < 0 || failed)
+      return;
+    queued.clear();
+    if (ftruncate(fd, 0) != 0 || fdatasync(fd) != 0)
+    {
+      failed = true;
+      fprintf(stderr, "journal: can't empty journal: %s\n", strerror(errno));
+    }
+  }
+} // namespace cw::journal
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,87 @@
+/* journal.hpp: Append-only log of generated nodes between checkpoints
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "base.hpp"
+#include "index.hpp"
+
+namespace cw::journal
+{
+  // The journal is a sequence of blocks, one per batch a worker hands over:
+  //
+  //   BlockHeader | Entry[count]
+  //
+  // with a checksum over the header's magic and count and every entry
+  // after it.  A crash can leave at most a torn block at the end, which
+  // replay spots by its checksum and cuts off.  Entries are written raw,
+  // like checkpoints, so a journal is only good on the host that wrote it.
+  constexpr u32 BLOCK_MAGIC = 0x424a5743; // "CWJB"
+
+  struct BlockHeader
+  {
+    u32 magic, count;
+    u64 checksum;
+  };
+
+  // Checksum of a block's entries, seeded with its header.
+  u64 checksum(const BlockHeader &, const cw::index::Entry *entries);
+
+  // Workers append whole batches, and each append has hit the disk by the
+  // time it returns.  Rather than a write and a sync per batch, whoever
+  // finds nobody writing takes every batch queued so far and writes them
+  // all with one write and one fdatasync (group commit), while the rest
+  // queue up behind it for the next one.  The more workers are appending,
+  // the more each sync covers.
+  struct Journal
+  {
+    Journal(void);
+    ~Journal(void);
+
+    // Open (or create) the journal at `path` for appending, first reading
+    // every intact block into `replayed`, in the order written, and cutting
+    // off anything after the last of them.  Prints why and returns false on
+    // failure.
+    bool open(const char *path, cw::index::Run &replayed);
+
+    // Append entries[0, n) as one block, durably.  Does nothing if the
+    // journal isn't open, or has failed to write (which it reports once).
+    void append(const cw::index::Entry *entries, u64 n);
+
+    // Empty the journal, once a checkpoint covers everything in it.  No
+    // appends may be running.
+    void reset(void);
+
+  private:
+    int fd;
+    std::mutex mutex;
+    std::condition_variable committed;
+    std::vector<u8> queued; // blocks nobody has started writing yet
+    u64 tickets, durable;   // appends queued so far, and of those written
+    bool writing, failed;
+  };
+} // namespace cw::journal
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,60 @@
+/* label.cpp: Cached text labels for fractions
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <raylib.h>
+
+#include "label.hpp"
+
+namespace cw::label
+{
+  using cw::node::Fraction;
+
+  bool LabelCache::Key::operator==(const Key &other) const
+  {
+    return numerator == other.numerator && denominator == other.denominator;
+  }
+
+  u64 LabelCache::KeyHash::operator()(const Key &key) const
+  {
+    return (key.numerator * 0x9E3779B97F4A7C15ULL) ^ key.denominator;
+  }
+
+  LabelCache::LabelCache(int font_size, u64 capacity)
+      : font_size{font_size}, capacity{capacity}
+  {
+    labels.reserve(capacity);
+  }
+
+  const Label &LabelCache::get(const Fraction &f)
+  {
+    Key key{f.numerator, f.denominator};
+    auto it = labels.find(key);
+    if (it != labels.end())
+      return it->second;
+
+    if (labels.size() >= capacity)
+      labels.clear();
+
+    Label label;
+    cw::format::format_fraction(label.text, f);
+    label.width = MeasureText(label.text, font_size);
+    return labels.emplace(key, label).first->second;
+  }
+} // namespace cw::label
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
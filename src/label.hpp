@@ -0,0 +1,67 @@
+/* label.hpp: Cached text labels for fractions
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef LABEL_HPP
+#define LABEL_HPP
+
+#include <unordered_map>
+
+#include "base.hpp"
+#include "format.hpp"
+#include "node.hpp"
+
+namespace cw::label
+{
+  constexpr u64 LABEL_SIZE = cw::format::FRACTION_SIZE;
+
+  struct Label
+  {
+    char text[LABEL_SIZE];
+    int width; // as measured by MeasureText
+  };
+
+  // Formatted and measured labels, keyed by fraction.  Each label is built
+  // once, so drawing it again costs neither an allocation nor a MeasureText.
+  // Forgets everything once it holds `capacity` labels.
+  struct LabelCache
+  {
+    int font_size;
+    u64 capacity;
+
+    LabelCache(int font_size, u64 capacity = 1 << 16);
+    const Label &get(const cw::node::Fraction &);
+
+  private:
+    struct Key
+    {
+      u64 numerator, denominator;
+      bool operator==(const Key &other) const;
+    };
+
+    struct KeyHash
+    {
+      u64 operator()(const Key &) const;
+    };
+
+    std::unordered_map<Key, Label, KeyHash> labels;
+  };
+} // namespace cw::label
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -5,96 +5,283 @@
  * Commentary: 2024-07-25
  */
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cmath>
 #include <cstdio>
-#include <iostream>
-#include <sstream>
-#include <stack>
+#include <cstring>
+#include <optional>
 #include <thread>
-#include <tuple>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <raylib.h>
 #include <raymath.h>
 
 #include "base.hpp"
+#include "checkpoint.hpp"
+#include "compact.hpp"
+#include "draw.hpp"
+#include "exporter.hpp"
+#include "format.hpp"
+#include "headless.hpp"
+#include "label.hpp"
 #include "node.hpp"
+#include "options.hpp"
+#include "query.hpp"
+#include "snapshot.hpp"
 #include "worker.hpp"
 
-#define WIDTH       1024
-#define HEIGHT      800
-#define FONT_SIZE   20
-#define CIRCLE_SIZE 2
-#define LINE_TOP    (7 * HEIGHT / 16)
-#define LINE_BOTTOM (9 * HEIGHT / 16)
-#define N_THREADS   15
+#define N_THREADS 15
+#define ZOOM_STEP 1.1f
+#define ZOOM_MIN  0.125
+#define ZOOM_MAX  1e13
 
 using cw::state::DrawState;
 using cw::state::State;
 
-std::pair<std::string, int> fraction_to_string(cw::node::Fraction f)
+#define MAX_LABELS 2048
+
+void draw_fraction(cw::label::LabelCache &cache, cw::node::Fraction f, f32 x,
+                   f32 y)
 {
-  std::string s{to_string(f)};
-  int width = MeasureText(s.c_str(), FONT_SIZE);
-  return std::make_pair(s, width);
+  const cw::label::Label &label = cache.get(f);
+  // Centered at (x, y), which may be off the left or top of the screen, so
+  // round to the nearest pixel rather than truncating.
+  const int left = static_cast<int>(std::lround(x)) - (label.width / 2);
+  const int top  = static_cast<int>(std::lround(y)) - FONT_SIZE;
+  DrawText(label.text, left, top, FONT_SIZE, WHITE);
 }
 
-void draw_fraction(cw::node::Fraction f, u64 x, u64 y)
+// Label the fraction f at world position (x, LINE_TOP), unless it'd overlap
+// the label before it (which ended at last_right on screen).
+void draw_label(cw::label::LabelCache &cache, cw::node::Fraction f, f64 x,
+                const cw::draw::Camera &camera, f32 &last_right)
 {
-  std::string s;
-  int width;
-  std::tie(s, width) = fraction_to_string(f);
-  // Centered at (x, y)
-  DrawText(s.c_str(), x - width / 2, y - FONT_SIZE, FONT_SIZE, WHITE);
+  Vector2 screen = camera.to_screen({x, LINE_TOP - camera.origin.y});
+  const cw::label::Label &label = cache.get(f);
+  if (screen.x - (label.width / 2) <= last_right + (FONT_SIZE / 2))
+    return;
+  draw_fraction(cache, f, screen.x, screen.y);
+  last_right = screen.x + (label.width / 2);
 }
 
-void draw_tree(DrawState &ds, State &state)
+// Label the ticks of the number line that are on screen, left to right,
+// skipping any which would overlap the label before it.  Rather than looking
+// at every node, each label is found by a search of the value index for the
+// first node clear of the last label, and at least a pixel on from the last
+// node tried.  So a frame costs O(WIDTH log n) at worst, however many nodes
+// there are or are on screen.
+void draw_labels(cw::label::LabelCache &cache,
+                 const cw::snapshot::Frame &frame, u64 count, DrawState &ds,
+                 const cw::draw::Camera &camera)
 {
-  // Number line
-  DrawLine(0, HEIGHT / 2, WIDTH, HEIGHT / 2, WHITE);
-
-  // Bounds
-  state.mutex.lock();
-  std::stack<std::pair<u64, f64>> stack;
-  cw::node::Node n = state.allocator.get_val(0);
-  stack.push(std::make_pair(0, n.value.norm));
-  while (!stack.empty())
+  if (!frame.index)
+    return;
+  cw::draw::Viewport view = cw::draw::viewport(camera, WIDTH, HEIGHT);
+  const cw::draw::LineMap map{ds, camera.origin};
+  const f64 end = map.value(view.right);
+
+  f32 last_right = -WIDTH;
+  const cw::index::Entry *entry =
+      frame.index->above(std::nextafter(map.value(view.left), -INFINITY));
+  while (entry && entry->norm() <= end)
   {
-    u64 node_index;
-    f64 norm;
-    std::tie(node_index, norm) = stack.top();
-    stack.pop();
-    u64 x = Remap(norm, ds.bounds.lower_val, ds.bounds.upper_val, 0, WIDTH);
-    DrawLine(x, LINE_TOP, x, LINE_BOTTOM, RED);
-
-    cw::node::Node n = state.allocator.get_val(node_index);
-    if (n.left >= 0)
-    {
-      cw::node::Node left = state.allocator.get_val(n.left);
-      stack.push(std::make_pair(n.left, left.value.norm));
-    }
-    if (n.right >= 0)
-    {
-      cw::node::Node right = state.allocator.get_val(n.right);
-      stack.push(std::make_pair(n.right, right.value.norm));
-    }
+    const f64 norm = entry->norm();
+    // The index may have got a little ahead of the frame's ticks.
+    if (entry->index() < count)
+      draw_label(cache, {entry->numerator, entry->denominator}, map.x(norm),
+                 camera, last_right);
+    const f32 next = MAX(camera.to_screen({map.x(norm), 0}).x + 1,
+                         last_right + (FONT_SIZE / 2));
+    entry = frame.index->above(
+        MAX(norm, map.value(camera.to_world({next, 0}).x)));
   }
-  state.mutex.unlock();
+}
+
+// Same as draw_labels, for the (already sorted) fractions of the deep zoom
+// view.
+void draw_deep_labels(cw::label::LabelCache &cache,
+                      const std::vector<cw::node::Located> &found,
+                      DrawState &ds, const cw::draw::Camera &camera)
+{
+  if (found.size() > MAX_LABELS)
+    return;
+  const cw::draw::LineMap map{ds, camera.origin};
+  f32 last_right = -WIDTH;
+  for (const auto &located : found)
+    draw_label(cache, located.value, map.x(located.value.norm), camera,
+               last_right);
+}
+
+static char *append(char *out, const char *str)
+{
+  while (*str)
+    *out++ = *str++;
+  *out = '\0';
+  return out;
+}
+
+#define PICK_RADIUS 8
+
+// Whatever node is under the mouse.
+struct Pick
+{
+  cw::node::Fraction value;
+  u64 depth;
+  // Fractions in the deep zoom view may lie too deep to have an index.
+  bool has_index;
+  u64 index;
+};
+
+// Find the node under the mouse, if there is one within PICK_RADIUS pixels.
+// A single lookup: O(log n) in the value index for the number line or in
+// the fractions found for deep zoom, O(1) for the graph.
+std::optional<Pick> pick(const cw::snapshot::Frame &frame, u64 count,
+                         const std::vector<cw::node::Located> &deep_found,
+                         DrawState &ds, const cw::draw::Camera &camera)
+{
+  Vector2 mouse = GetMousePosition();
+  // Offsets on the number line stay relative to the origin, as only they are
+  // precise; the graph is never zoomed far enough to need it.
+  cw::draw::Point relative = camera.to_world(mouse);
+  cw::draw::Point world    = {relative.x + camera.origin.x,
+                              relative.y + camera.origin.y};
+  const cw::draw::LineMap map{ds, camera.origin};
+  auto near = [&](f64 norm) {
+    return std::abs(camera.to_screen({map.x(norm), 0}).x - mouse.x) <=
+           PICK_RADIUS;
+  };
+
+  switch (ds.view)
+  {
+  case DrawState::View::NUMBER_LINE:
+  {
+    if (world.y < LINE_TOP || world.y > LINE_BOTTOM || !frame.index)
+      return std::nullopt;
+    const cw::index::Entry *entry = frame.index->nearest(map.value(relative.x));
+    if (!entry || !near(entry->norm()))
+      return std::nullopt;
+    u64 index = entry->index();
+    return Pick{cw::node::unrank(index), cw::node::depth(index), true, index};
+  }
+  case DrawState::View::GRAPH:
+  {
+    if (world.x < 0 || world.y < 0 || world.x >= WIDTH)
+      return std::nullopt;
+    u64 depth = world.y / cw::draw::GRAPH_LEVEL_HEIGHT;
+    if (depth > 62)
+      return std::nullopt;
+    u64 index = (1ULL << depth) - 1 + ((world.x * (1ULL << depth)) / WIDTH);
+    if (index >= count)
+      return std::nullopt;
+    return Pick{cw::node::unrank(index), depth, true, index};
+  }
+  case DrawState::View::DEEP_ZOOM:
+  {
+    if (world.y < LINE_TOP || world.y > LINE_BOTTOM || deep_found.empty())
+      return std::nullopt;
+    f64 x   = map.value(relative.x);
+    auto it = std::lower_bound(
+        deep_found.begin(), deep_found.end(), x,
+        [](const cw::node::Located &l, f64 x) { return l.value.norm < x; });
+    if (it == deep_found.end() ||
+        (it != deep_found.begin() &&
+         x - (it - 1)->value.norm < it->value.norm - x))
+      --it;
+    if (!near(it->value.norm))
+      return std::nullopt;
+    auto index = cw::node::rank(it->value.numerator, it->value.denominator);
+    return Pick{it->value, it->depth, index.has_value(), index.value_or(0)};
+  }
+  }
+  return std::nullopt;
+}
+
+void draw_tooltip(const Pick &pick)
+{
+  using cw::format::format_u64;
+  char text[512];
+  char *ptr = cw::format::format_fraction(text, pick.value);
+  ptr += sprintf(ptr, "\n\n= %.15g", pick.value.norm);
+  ptr = append(ptr, "\n\nDepth=");
+  ptr = format_u64(ptr, pick.depth);
+  if (pick.has_index)
+  {
+    ptr = append(ptr, "\n\nIndex=");
+    ptr = format_u64(ptr, pick.index);
+    ptr = append(ptr, "\n\nPath=");
+    cw::format::format_path(ptr, pick.index);
+  }
+
+  Vector2 mouse = GetMousePosition();
+  int width     = MeasureText(text, FONT_SIZE);
+  int height    = (pick.has_index ? 5 : 3) * FONT_SIZE * 2;
+  int x         = MIN(mouse.x + FONT_SIZE, WIDTH - width - FONT_SIZE);
+  int y         = MIN(mouse.y + FONT_SIZE, HEIGHT - height);
+  DrawRectangle(x - 4, y - 4, width + 8, height + 8, Fade(DARKGRAY, 0.9f));
+  DrawText(text, x, y, FONT_SIZE, WHITE);
+}
 
-  DrawLine(0, LINE_TOP, 0, LINE_BOTTOM, WHITE);
-  DrawText("0", 0, LINE_TOP - FONT_SIZE, FONT_SIZE, WHITE);
-  DrawLine(WIDTH, LINE_TOP, WIDTH, LINE_BOTTOM, WHITE);
+// Label the bounds of the number line.
+void draw_tree(DrawState &ds, const cw::draw::Camera &camera)
+{
+  const cw::draw::LineMap map{ds, camera.origin};
+  const f64 y   = LINE_TOP - camera.origin.y;
+  Vector2 left  = camera.to_screen({map.x(ds.bounds.lower_val), y});
+  Vector2 right = camera.to_screen({map.x(ds.bounds.upper_val), y});
+  DrawText("0", left.x, left.y - FONT_SIZE, FONT_SIZE, WHITE);
   char buffer[64];
   sprintf(buffer, "%d", (int)ds.bounds.upper_val);
-  DrawText(buffer, WIDTH - (FONT_SIZE / 2), LINE_TOP - FONT_SIZE, FONT_SIZE,
+  DrawText(buffer, right.x - (FONT_SIZE / 2), right.y - FONT_SIZE, FONT_SIZE,
            WHITE);
 }
 
+// Write the whole tree out to options.dump.
+bool dump(const cw::node::NodeAllocator &allocator,
+          const cw::options::Options &options)
+{
+  const bool to_stdout = options.dump == "-";
+  int fd               = to_stdout ? STDOUT_FILENO
+                                   : open(options.dump.c_str(),
+                                          O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  bool ok = fd >= 0;
+  if (ok)
+  {
+    cw::serialise::Writer out{fd};
+    ok = cw::serialise::write(out, allocator, options.dump_format);
+  }
+  if (!to_stdout && fd >= 0)
+    ok = close(fd) == 0 && ok;
+  if (!ok)
+    fprintf(stderr, "dump: failed writing `%s`: %s\n", options.dump.c_str(),
+            strerror(errno));
+  return ok;
+}
+
 using Clock = std::chrono::steady_clock;
 using Ms    = std::chrono::milliseconds;
 
-int main(void)
+int main(int argc, char *argv[])
 {
+  cw::options::Options options = cw::options::parse(argc, argv);
+  if (!options.serve.empty())
+    return cw::query::serve(options.serve) ? 0 : 1;
+  if (options.export_bench > 0)
+  {
+    if (options.export_to.empty())
+    {
+      fprintf(stderr, "--export-bench needs an --export FILE to write to\n");
+      return 1;
+    }
+    return cw::exporter::bench(options.export_to.c_str(),
+                               options.export_bench, options.export_depth)
+               ? 0
+               : 1;
+  }
+
   // Init timer
   auto time_current         = Clock::now();
   auto time_previous        = time_current;
@@ -104,16 +291,46 @@ int main(void)
   cw::state::State state;
   state.stop_work  = false;
   state.pause_work = false;
-  state.allocator.alloc(cw::node::Node{{1, 1}, -1, -1});
-  state.queue.push(0);
+  using cw::checkpoint::Restore;
+  Restore restored = Restore::MISSING;
+  if (!options.checkpoint.empty())
+    restored = cw::checkpoint::restore(state, options.checkpoint.c_str(),
+                                       options.verify_checkpoint);
+  if (restored == Restore::FAILED)
+    return 1;
+  if (restored == Restore::MISSING)
+    state.allocator.alloc(cw::node::Node{{1, 1}, -1, -1});
+  if (!options.journal.empty())
+  {
+    cw::index::Run journalled;
+    if (!state.journal.open(options.journal.c_str(), journalled))
+      return 1;
+    u64 replayed = cw::checkpoint::replay(state, std::move(journalled));
+    if (replayed > 0)
+      fprintf(stderr, "journal: replayed %lu nodes\n", replayed);
+  }
+  if (!options.export_to.empty() &&
+      !state.exporter.open(options.export_to.c_str(), options.export_depth))
+    return 1;
 
-  cw::state::DrawState draw_state{state};
+  cw::state::DrawState draw_state;
+  draw_state.view      = options.view;
+  draw_state.colouring = options.colouring;
+  cw::draw::NumberLine number_line;
+  cw::draw::Graph graph;
+  cw::draw::Geometry deep_geometry, highlights;
+  u64 recent[RECENT_SIZE];
+  std::vector<cw::node::Located> deep_found;
+  cw::snapshot::Pipeline pipeline;
 
   // Init meta text (counter, iterations, etc)
   u64 count = 1, prev_count = 0;
-  std::stringstream format_stream;
-  std::string format_str;
+  // rebuild_line: the nodes, colours or origin changed.  rebuild_deep: the
+  // deep zoom doesn't depend on the count, only on the bounds it sets.
+  bool rebuild_line = true, rebuild_deep = true;
+  char format_str[256] = "";
   u64 format_str_width = 0;
+  cw::label::LabelCache label_cache{FONT_SIZE};
 
   // Init threads
   std::thread threads[N_THREADS];
@@ -121,17 +338,54 @@ int main(void)
   {
     threads[i] = std::move(std::thread(cw::worker::worker, std::ref(state)));
   }
+  std::thread snapshot_thread{cw::snapshot::snapshotter, std::ref(state),
+                              std::ref(pipeline)};
+  // Catch everything fed from the nodes up with what we started from, while
+  // generation carries on from it.
+  std::thread reindex_thread{cw::checkpoint::reindex, std::ref(state),
+                             state.allocator.size()};
+
+  // Stop generating, and leave a checkpoint behind if asked for one.
+  auto finish = [&]() {
+    state.stop_work = true;
+    for (auto &thread : threads)
+      thread.join();
+    snapshot_thread.join();
+    reindex_thread.join();
+    bool saved = true;
+    if (!options.checkpoint.empty())
+    {
+      const char *path = options.checkpoint.c_str();
+      saved = options.compact_checkpoint ? cw::compact::save(state, path)
+                                         : cw::checkpoint::save(state, path);
+      // Everything journalled is in the checkpoint now.
+      if (saved)
+        state.journal.reset();
+    }
+    // The dump and export are on the side: them failing mustn't cost the
+    // checkpoint, only the exit code.
+    const bool dumped = options.dump.empty() || dump(state.allocator, options);
+    const bool exported = state.exporter.close();
+    return saved && dumped && exported ? 0 : 1;
+  };
+
+  if (options.headless)
+  {
+    cw::headless::run(pipeline, options);
+    return finish();
+  }
 
   // Setup raylib window
   InitWindow(WIDTH, HEIGHT, "Calkin-Wilf tree");
   SetTargetFPS(60);
 
   // setup camera
-  Camera2D camera;
-  camera.target   = {.x = 0, .y = 0};
-  camera.offset   = {.x = WIDTH / 16, .y = 0};
-  camera.rotation = 0.0f;
-  camera.zoom     = 0.8f;
+  cw::draw::Camera camera      = cw::draw::default_camera();
+  cw::draw::Camera prev_camera = camera;
+  auto prev_view               = draw_state.view;
+
+  // Views are drawn progressively, across frames if need be.
+  cw::draw::Progressive progressive{WIDTH, HEIGHT};
 
   while (!WindowShouldClose())
   {
@@ -142,62 +396,146 @@ int main(void)
             time_delta)
     {
       time_previous = time_current;
-      count         = state.allocator.vec.size();
+      if (pipeline.acquire())
+        count = pipeline.front().count();
     }
 
     if (prev_count != count)
     {
-      draw_state.compute_bounds();
+      const auto bounds = draw_state.bounds;
+      draw_state.compute_bounds(count);
       prev_count = count;
-      format_stream << "Count=" << count << "\n\n"
-                    << "Iterations=" << (count - 1) / 2 << "\n\n"
-                    << "Lower=" << to_string(draw_state.bounds.leftmost.value)
-                    << "\n\n"
-                    << "Upper=" << to_string(draw_state.bounds.rightmost.value);
-      format_str = format_stream.str();
-      format_stream.str("");
-      format_str_width = MeasureText(format_str.c_str(), FONT_SIZE * 2);
+      rebuild_line = true;
+      rebuild_deep |= bounds.lower_val != draw_state.bounds.lower_val ||
+                      bounds.upper_val != draw_state.bounds.upper_val;
+      using cw::format::format_fraction, cw::format::format_u64;
+      char *ptr = append(format_str, "Count=");
+      ptr       = format_u64(ptr, count);
+      ptr       = append(ptr, "\n\nIterations=");
+      ptr       = format_u64(ptr, (count - 1) / 2);
+      ptr       = append(ptr, "\n\nLower=");
+      ptr       = format_fraction(ptr, draw_state.bounds.leftmost.value);
+      ptr       = append(ptr, "\n\nUpper=");
+      ptr       = format_fraction(ptr, draw_state.bounds.rightmost.value);
+      if (auto gap = state.gaps.max_gap())
+        ptr += sprintf(ptr, "\n\nMax gap=%.3g", gap->length);
+      ptr = append(ptr, "\n\nFarey complete to Q=");
+      format_u64(ptr, state.farey.complete_to());
+      format_str_width = MeasureText(format_str, FONT_SIZE * 2);
     }
 
     if (IsKeyPressed(KEY_SPACE))
       state.pause_work = !state.pause_work;
 
-    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT))
+    if (IsKeyPressed(KEY_G))
+      draw_state.view = draw_state.view == DrawState::View::GRAPH
+                            ? DrawState::View::NUMBER_LINE
+                            : DrawState::View::GRAPH;
+
+    if (IsKeyPressed(KEY_D))
+      draw_state.view = draw_state.view == DrawState::View::DEEP_ZOOM
+                            ? DrawState::View::NUMBER_LINE
+                            : DrawState::View::DEEP_ZOOM;
+
+    if (IsKeyPressed(KEY_C))
     {
-      Vector2 delta = GetMouseDelta();
-      delta         = Vector2Scale(delta, -1.0f / camera.zoom);
-      camera.target = Vector2Add(camera.target, delta);
+      using Colouring      = DrawState::Colouring;
+      int next             = static_cast<int>(draw_state.colouring) + 1;
+      draw_state.colouring = static_cast<Colouring>(
+          next % (static_cast<int>(Colouring::POSITION) + 1));
+      rebuild_line = true;
+      rebuild_deep = true;
     }
+
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT))
+      camera.pan(GetMouseDelta());
     float wheel = GetMouseWheelMove();
     if (wheel != 0)
     {
-      Vector2 mouse_to_world = GetScreenToWorld2D(GetMousePosition(), camera);
-      camera.offset          = GetMousePosition();
-      camera.target          = mouse_to_world;
-      camera.zoom            = Clamp(camera.zoom + (wheel * 0.1f), 0.125, 64);
+      camera.zoom_at(GetMousePosition(), std::pow(ZOOM_STEP, wheel), ZOOM_MIN,
+                     ZOOM_MAX);
       printf("%lf\n", camera.zoom);
     }
+    // Geometry is relative to the camera's origin, so it only needs
+    // rebuilding when the origin moves, not whenever the camera does.
+    if (camera.rebase())
+      rebuild_line = true;
+
+    // Work out how much of what's already been drawn is still good.  New
+    // nodes usually only append to the geometry, so the progressive draw
+    // carries on from where it was rather than starting again.
+    bool reset = camera != prev_camera || draw_state.view != prev_view;
+    if (rebuild_line)
+      reset |= number_line.update(pipeline.front().norms.data(), count,
+                                  draw_state, camera.origin);
+    cw::draw::Viewport view = cw::draw::viewport(camera, WIDTH, HEIGHT);
+    switch (draw_state.view)
+    {
+    case DrawState::View::NUMBER_LINE:
+      break;
+    case DrawState::View::GRAPH:
+      if (reset || rebuild_line)
+        reset |= graph.update(view, WIDTH, count, draw_state, 2 * WIDTH,
+                              camera.origin);
+      break;
+    case DrawState::View::DEEP_ZOOM:
+      if (reset || rebuild_deep)
+      {
+        cw::draw::build_deep_zoom(deep_geometry, deep_found, view, draw_state,
+                                  camera.origin);
+        rebuild_deep = false;
+        reset        = true;
+      }
+      break;
+    }
+    if (reset)
+      progressive.reset();
+    rebuild_line = false;
+    prev_camera  = camera;
+    prev_view    = draw_state.view;
 
     // Draw
 
-    ClearBackground(BLACK);
     BeginDrawing();
-    BeginMode2D(camera);
-    draw_tree(draw_state, state);
+    ClearBackground(BLACK);
+    switch (draw_state.view)
+    {
+    case DrawState::View::NUMBER_LINE:
+      progressive.step(number_line.geometry, camera.relative(), 0);
+      break;
+    case DrawState::View::GRAPH:
+      progressive.step(graph.geometry, camera.relative(),
+                       CIRCLE_SIZE / camera.zoom);
+      break;
+    case DrawState::View::DEEP_ZOOM:
+      progressive.step(deep_geometry, camera.relative(), 0);
+      break;
+    }
+    progressive.draw();
+    // The latest expansions change every frame, so they're drawn over the
+    // top rather than progressively.
+    cw::draw::build_highlights(highlights, recent, state.recent.read(recent),
+                               WIDTH, draw_state, camera.origin);
+    BeginMode2D(camera.relative());
+    cw::draw::submit(highlights, 2 * CIRCLE_SIZE / camera.zoom);
     EndMode2D();
-    DrawText(format_str.c_str(), (31 * WIDTH / 32) - format_str_width / 2,
+    if (draw_state.view != DrawState::View::GRAPH)
+      draw_tree(draw_state, camera);
+    if (draw_state.view == DrawState::View::NUMBER_LINE)
+      draw_labels(label_cache, pipeline.front(), count, draw_state, camera);
+    else if (draw_state.view == DrawState::View::DEEP_ZOOM)
+      draw_deep_labels(label_cache, deep_found, draw_state, camera);
+    DrawText(format_str, (31 * WIDTH / 32) - format_str_width / 2,
              HEIGHT / 32, FONT_SIZE, WHITE);
+    if (auto picked =
+            pick(pipeline.front(), count, deep_found, draw_state, camera))
+      draw_tooltip(*picked);
     EndDrawing();
   }
 
+  progressive.unload();
   CloseWindow();
-
-  state.stop_work = true;
-  for (auto &thread : threads)
-  {
-    thread.join();
-  }
-  return 0;
+  return finish();
 }
 
 /* Copyright (C) 2024, 2025 Aryadev Chavali
@@ -5,9 +5,12 @@
  * Commentary:
  */
 
-#include <sstream>
+#include <algorithm>
 
+#include "continued.hpp"
+#include "format.hpp"
 #include "node.hpp"
+#include "parallel.hpp"
 
 namespace cw::node
 {
@@ -41,9 +44,145 @@ namespace cw::node
 
   std::string to_string(const Fraction &f)
   {
-    std::stringstream ss;
-    ss << f.numerator << "/" << f.denominator;
-    return ss.str();
+    char buffer[cw::format::FRACTION_SIZE];
+    char *end = cw::format::format_fraction(buffer, f);
+    return std::string(buffer, end);
+  }
+
+  Fraction unrank(u64 index)
+  {
+    // Bits of index + 1 below the leading one spell out the path from the
+    // root: 0 for a left child, 1 for a right child.
+    u64 path = index + 1;
+    int bit  = 63;
+    while (bit > 0 && !(path & (1ULL << bit)))
+      --bit;
+
+    u64 num = 1, den = 1;
+    for (--bit; bit >= 0; --bit)
+    {
+      if (path & (1ULL << bit))
+        num += den;
+      else
+        den += num;
+    }
+    return Fraction{num, den};
+  }
+
+  Fraction next(const Fraction &f)
+  {
+    // 1 / (2 * floor(x) - x + 1)
+    u64 whole = f.numerator / f.denominator;
+    return Fraction{f.denominator,
+                    ((2 * whole) + 1) * f.denominator - f.numerator};
+  }
+
+  std::optional<u64> rank(u64 p, u64 q)
+  {
+    if (p == 0 || q == 0)
+      return std::nullopt;
+
+    // Bits of index + 1 below the leading one: the Calkin-Wilf path is the
+    // Stern-Brocot path reversed, so its first run from the root is the last
+    // step down to the node, the lowest bit.  Right steps are ones.
+    u64 path = 0, depth = 0;
+    bool fits = true;
+    u64 gcd   = for_each_run(p, q, [&](Run run) {
+      if (run.length > 63 - depth)
+        return fits = false;
+      if (run.right)
+        path |= ((1ULL << run.length) - 1) << depth;
+      depth += run.length;
+      return true;
+    });
+    if (!fits || gcd != 1)
+      return std::nullopt;
+    return ((1ULL << depth) | path) - 1;
+  }
+
+  void rank(const Fraction *fractions, std::optional<u64> *indices, u64 n)
+  {
+    parallel::for_range(0, n, [&](u64 begin, u64 end) {
+      for (u64 i = begin; i < end; ++i)
+        indices[i] = rank(fractions[i].numerator, fractions[i].denominator);
+    });
+  }
+
+  u64 order_key(u64 p, u64 q)
+  {
+    if (p == 0)
+      return 0;
+    if (q == 0)
+      return ~0ULL;
+
+    // Stern-Brocot path from the top, right steps as ones from the top bit
+    // down, cut off at depth 63.
+    u64 key = 0, depth = 0;
+    for_each_run(p, q, [&](Run run) {
+      u64 steps = MIN(run.length, 63 - depth);
+      if (run.right)
+        key |= ((1ULL << steps) - 1) << (64 - depth - steps);
+      depth += steps;
+      return depth < 63;
+    });
+    return key | (1ULL << (63 - depth));
+  }
+
+  // Number of x in [1, n] whose bits reversed are below `key` (or equal to
+  // it, if `inclusive`).  Bit j of x is bit 63 - j of its reverse, so going
+  // from the bottom bit of x up, the comparison with key is settled by the
+  // first bit that differs, while the comparison with n is settled by the
+  // last.  Track how many words (of the bits so far) are in each state.
+  static u64 count_reversed(u64 n, u64 key, bool inclusive)
+  {
+    enum
+    {
+      LESS,
+      EQUAL,
+      GREATER
+    };
+    // ways[r][c]: r compares the reverse with key, c is whether the word is
+    // at most n so far.
+    unsigned __int128 ways[3][2] = {{0, 0}, {0, 1}, {0, 0}};
+    for (u64 j = 0; j < 64; ++j)
+    {
+      unsigned __int128 next[3][2] = {};
+      const u64 key_bit = (key >> (63 - j)) & 1, n_bit = (n >> j) & 1;
+      for (u64 r = LESS; r <= GREATER; ++r)
+        for (u64 c = 0; c < 2; ++c)
+          for (u64 bit = 0; bit < 2; ++bit)
+          {
+            u64 r_next = r;
+            if (r == EQUAL && bit != key_bit)
+              r_next = bit < key_bit ? LESS : GREATER;
+            u64 c_next = bit == n_bit ? c : bit < n_bit;
+            next[r_next][c_next] += ways[r][c];
+          }
+      std::copy(&next[0][0], &next[0][0] + 6, &ways[0][0]);
+    }
+    unsigned __int128 total = ways[LESS][1] + (inclusive ? ways[EQUAL][1] : 0);
+    // x = 0 isn't an index + 1, but its reverse is below any nonzero key.
+    if (key > 0 || inclusive)
+      --total;
+    return total;
+  }
+
+  u64 count_range(u64 count, const Fraction &lower, const Fraction &upper)
+  {
+    u64 lo = order_key(lower.numerator, lower.denominator);
+    u64 hi = order_key(upper.numerator, upper.denominator);
+    if (count == 0 || lo > hi)
+      return 0;
+    return count_reversed(count, hi, true) - count_reversed(count, lo, false);
+  }
+
+  void count_range(const RangeQuery *queries, u64 *counts, u64 n)
+  {
+    parallel::for_range(0, n, [&](u64 begin, u64 end) {
+      for (u64 i = begin; i < end; ++i)
+        counts[i] =
+            count_range(queries[i].count, queries[i].lower, queries[i].upper);
+    });
   }
 
   /***************************/
@@ -65,7 +204,7 @@ namespace cw::node
 
   u64 NodeAllocator::alloc(Node n)
   {
-    u64 ind = vec.size();
+    u64 ind = size();
     vec.push_back(n);
     return ind;
   }
@@ -73,50 +212,30 @@ namespace cw::node
   // FIXME: This is annoying.  DRY?
   Node &NodeAllocator::get_ref(u64 n)
   {
-    if (n >= vec.size())
-      return vec[0];
-    return vec[n];
+    if (n >= size())
+      n = 0;
+    return n < adopted_count ? adopted[n] : vec[n - adopted_count];
   }
 
   Node NodeAllocator::get_val(u64 n) const
   {
-    if (n >= vec.size())
-      return vec[0];
-    return vec[n];
+    if (n >= size())
+      n = 0;
+    return n < adopted_count ? adopted[n] : vec[n - adopted_count];
   }
 
-  void indent_depth(int depth, std::stringstream &ss)
+  u64 NodeAllocator::size(void) const
   {
-    for (int i = 0; i < depth; ++i)
-      ss << "  ";
+    return adopted_count + vec.size();
   }
 
-  std::string to_string(const NodeAllocator &allocator, const i64 n, int depth)
+  void NodeAllocator::adopt(Node *nodes, u64 n, std::shared_ptr<void> owner)
   {
-    if (n < 0)
-      return "NIL";
-
-    std::stringstream ss;
-    Node x = allocator.get_val(n);
-    ss << "(" << to_string(x.value) << "\n";
-
-    indent_depth(depth, ss);
-    if (x.left == -1)
-      ss << "NIL";
-    else
-      ss << to_string(allocator, x.left, depth + 1);
-    ss << "\n";
-
-    indent_depth(depth, ss);
-    if (x.right == -1)
-      ss << "NIL";
-    else
-      ss << to_string(allocator, x.right, depth + 1);
-
-    ss << ")";
-    return ss.str();
+    assert(size() == 0);
+    adopted       = nodes;
+    adopted_count = n;
+    adopted_owner = std::move(owner);
   }
-
 } // namespace cw::node
 
 /* Copyright (C) 2025 Aryadev Chavali
@@ -8,6 +8,8 @@
 #ifndef NODE_HPP
 #define NODE_HPP
 
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -29,6 +31,86 @@ namespace cw::node
 
   std::string to_string(const Fraction &);
 
+  // The Calkin-Wilf tree is generated in breadth first order, so the node at
+  // index i has children at 2i + 1 and 2i + 2 and its fraction is fully
+  // determined by i.
+
+  // Depth of the node at BFS index `index`: floor(log2(index + 1)), by
+  // counting leading zeros (lzcnt where the target has it).  index must be
+  // less than 2^64 - 1.
+  inline u64 depth(u64 index)
+  {
+    return 63 - __builtin_clzll(index + 1);
+  }
+
+  // Fraction at BFS index `index` (0 being 1/1).  O(depth).
+  Fraction unrank(u64 index);
+
+  // Fraction following `f` in BFS order (Newman's formula).  O(1).
+  Fraction next(const Fraction &f);
+
+  // BFS index of numerator/denominator: the inverse of unrank.  Walks the
+  // path back up to the root with the Euclidean algorithm, taking each run of
+  // identical steps in one division, so O(log) rather than O(depth).  Empty
+  // if the fraction isn't in the tree (zero, or not reduced) or lies deeper
+  // than 63, past which its index won't fit in 64 bits.
+  std::optional<u64> rank(u64 numerator, u64 denominator);
+
+  // rank of each of fractions[0, n) into indices[0, n), in parallel.
+  void rank(const Fraction *fractions, std::optional<u64> *indices, u64 n);
+
+  // key_of_index of the node holding numerator/denominator, straight from its
+  // Stern-Brocot path (by the Euclidean algorithm, a run of steps at a time).
+  // Past depth 63 it's the key of the value's ancestor at depth 63, which
+  // still orders the same against every node above that depth.  Zero orders
+  // below everything and 1/0 above.
+  u64 order_key(u64 numerator, u64 denominator);
+
+  // Number of the first `count` nodes whose values lie in [lower, upper].
+  // The first `count` nodes are fixed by count alone: node i is in range iff
+  // i < count and key_of_index(i), the bits of i + 1 reversed, lies between
+  // the keys of the bounds.  So rather than building anything over the nodes,
+  // this counts the 64 bit words x = i + 1 satisfying both at once, one bit
+  // at a time.  O(64), with no memory and no lock; count must be below 2^63.
+  u64 count_range(u64 count, const Fraction &lower, const Fraction &upper);
+
+  struct RangeQuery
+  {
+    u64 count;
+    Fraction lower, upper;
+  };
+
+  // count_range for each of queries[0, n) into counts[0, n), in parallel.
+  void count_range(const RangeQuery *queries, u64 *counts, u64 n);
+
+  // Swap bits within each byte, then bytes within the word.
+  inline u64 reverse_bits(u64 x)
+  {
+    constexpr u64 ODD = 0x5555555555555555ULL, PAIRS = 0x3333333333333333ULL,
+                  NIBBLES = 0x0F0F0F0F0F0F0F0FULL;
+    x = ((x >> 1) & ODD) | ((x & ODD) << 1);
+    x = ((x >> 2) & PAIRS) | ((x & PAIRS) << 2);
+    x = ((x >> 4) & NIBBLES) | ((x & NIBBLES) << 4);
+    return __builtin_bswap64(x);
+  }
+
+  // Key of the node at BFS index `index` which orders exactly as the
+  // fractions do, without any arithmetic on the fractions.  A node's path in
+  // the Calkin-Wilf tree, reversed, is its path in the Stern-Brocot tree,
+  // whose in-order walk is numeric order.  So the key is the Stern-Brocot
+  // path (0 left, 1 right) followed by a 1, read as a binary fraction:
+  // exactly index + 1 with its bits reversed.  index must be less than
+  // 2^64 - 1.
+  inline u64 key_of_index(u64 index)
+  {
+    return reverse_bits(index + 1);
+  }
+
+  inline u64 index_of_key(u64 key)
+  {
+    return reverse_bits(key) - 1;
+  }
+
   struct Node
   {
     Fraction value;
@@ -39,12 +121,24 @@ namespace cw::node
 
   struct NodeAllocator
   {
+    // Nodes after the adopted ones (all of them, if none were adopted).
     std::vector<Node> vec;
 
     NodeAllocator(u64 capacity = 256);
     u64 alloc(Node n);
     Node get_val(u64 n) const;
     Node &get_ref(u64 n);
+    u64 size(void) const;
+
+    // Use nodes[0, n) in place as the first n nodes, without copying them:
+    // `owner` keeps them alive, say as a mapped checkpoint.  Only for an
+    // empty allocator.
+    void adopt(Node *nodes, u64 n, std::shared_ptr<void> owner);
+
+  private:
+    Node *adopted     = nullptr;
+    u64 adopted_count = 0;
+    std::shared_ptr<void> adopted_owner;
   };
 
   std::string to_string(const NodeAllocator &, const i64, int depth = 1);
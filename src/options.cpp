@@ -0,0 +1,209 @@
+/* options.cpp: Command line options
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "options.hpp"
+
+namespace cw::options
+{
+  using cw::state::DrawState;
+
+  Options::Options(void)
+      : headless{false}, view{DrawState::View::NUMBER_LINE},
+        colouring{DrawState::Colouring::PLAIN}, frame_every{1024},
+        max_nodes{0}, frames_dir{"."}, frame_format{FrameFormat::PNG},
+        serve{}, checkpoint{},
+        compact_checkpoint{false}, verify_checkpoint{false}, journal{},
+        export_to{}, export_depth{EXPORT_DEPTH}, export_bench{0}, dump{},
+        dump_format{cw::serialise::Format::SEXP}
+  {
+  }
+
+  [[noreturn]] static void usage(const char *program, int code)
+  {
+    FILE *fp = code == 0 ? stdout : stderr;
+    fprintf(fp,
+            "Usage: %s [OPTIONS]\n"
+            "  --headless         run without a window, writing frames\n"
+            "  --view line|graph|deep\n"
+            "                     view to render (default line)\n"
+            "  --colour plain|depth|recency|position\n"
+            "                     what to colour nodes by (default plain)\n"
+            "  --frame-every N    write a frame every N nodes (default 1024)\n"
+            "  --max-nodes N      stop after N nodes (default never)\n"
+            "  --frames-dir DIR   directory for frames (default .)\n"
+            "  --format png|ppm   frame format (default png)\n"
+            "  --serve PATH       answer rank/unrank/range queries on a Unix\n"
+            "                     socket at PATH, or stdin/stdout for -\n"
+            "  --checkpoint FILE  carry on from FILE if it exists, and save\n"
+            "                     progress to it on exit\n"
+            "  --checkpoint-format raw|compact\n"
+            "                     raw maps straight back in, compact stores\n"
+            "                     next to nothing (default raw)\n"
+            "  --verify-checkpoint\n"
+            "                     check a raw checkpoint's checksums and\n"
+            "                     links before carrying on from it\n"
+            "  --journal FILE     log nodes to FILE as they're generated, and\n"
+            "                     replay it on startup\n"
+            "  --export FILE      stream nodes to FILE as they're generated\n"
+            "  --export-depth N   buffers being written at once (default 32)\n"
+            "  --export-bench N   time exporting N nodes to the --export FILE\n"
+            "                     with io_uring and with pwrite, then exit\n"
+            "  --dump FILE        write the tree to FILE (- for stdout) on\n"
+            "                     exit\n"
+            "  --dump-format sexp|csv|binary\n"
+            "                     format to dump in (default sexp)\n"
+            "  --help             print this message\n",
+            program);
+    exit(code);
+  }
+
+  static u64 parse_u64(const char *program, const char *flag, const char *arg)
+  {
+    char *end = nullptr;
+    u64 n     = strtoull(arg, &end, 10);
+    if (*arg == '\0' || *end != '\0')
+    {
+      fprintf(stderr, "%s: %s expects a number, got `%s`\n", program, flag,
+              arg);
+      usage(program, 1);
+    }
+    return n;
+  }
+
+  Options parse(int argc, char *argv[])
+  {
+    Options options;
+    const char *program = argc > 0 ? argv[0] : "cw_tree";
+    for (int i = 1; i < argc; ++i)
+    {
+      const char *flag = argv[i];
+      if (strcmp(flag, "--help") == 0)
+        usage(program, 0);
+      else if (strcmp(flag, "--headless") == 0)
+      {
+        options.headless = true;
+        continue;
+      }
+      else if (strcmp(flag, "--verify-checkpoint") == 0)
+      {
+        options.verify_checkpoint = true;
+        continue;
+      }
+
+      // Everything else takes an argument.
+      if (i + 1 >= argc)
+      {
+        fprintf(stderr, "%s: %s expects an argument\n", program, flag);
+        usage(program, 1);
+      }
+      const char *arg = argv[++i];
+
+      if (strcmp(flag, "--view") == 0)
+      {
+        if (strcmp(arg, "line") == 0)
+          options.view = DrawState::View::NUMBER_LINE;
+        else if (strcmp(arg, "graph") == 0)
+          options.view = DrawState::View::GRAPH;
+        else if (strcmp(arg, "deep") == 0)
+          options.view = DrawState::View::DEEP_ZOOM;
+        else
+          usage(program, 1);
+      }
+      else if (strcmp(flag, "--colour") == 0)
+      {
+        using Colouring = DrawState::Colouring;
+        if (strcmp(arg, "plain") == 0)
+          options.colouring = Colouring::PLAIN;
+        else if (strcmp(arg, "depth") == 0)
+          options.colouring = Colouring::DEPTH;
+        else if (strcmp(arg, "recency") == 0)
+          options.colouring = Colouring::RECENCY;
+        else if (strcmp(arg, "position") == 0)
+          options.colouring = Colouring::POSITION;
+        else
+          usage(program, 1);
+      }
+      else if (strcmp(flag, "--frame-every") == 0)
+        options.frame_every = MAX(1, parse_u64(program, flag, arg));
+      else if (strcmp(flag, "--max-nodes") == 0)
+        options.max_nodes = parse_u64(program, flag, arg);
+      else if (strcmp(flag, "--frames-dir") == 0)
+        options.frames_dir = arg;
+      else if (strcmp(flag, "--format") == 0)
+      {
+        if (strcmp(arg, "png") == 0)
+          options.frame_format = FrameFormat::PNG;
+        else if (strcmp(arg, "ppm") == 0)
+          options.frame_format = FrameFormat::PPM;
+        else
+          usage(program, 1);
+      }
+      else if (strcmp(flag, "--serve") == 0)
+        options.serve = arg;
+      else if (strcmp(flag, "--checkpoint") == 0)
+        options.checkpoint = arg;
+      else if (strcmp(flag, "--checkpoint-format") == 0)
+      {
+        if (strcmp(arg, "raw") == 0)
+          options.compact_checkpoint = false;
+        else if (strcmp(arg, "compact") == 0)
+          options.compact_checkpoint = true;
+        else
+          usage(program, 1);
+      }
+      else if (strcmp(flag, "--journal") == 0)
+        options.journal = arg;
+      else if (strcmp(flag, "--export") == 0)
+        options.export_to = arg;
+      else if (strcmp(flag, "--export-depth") == 0)
+      {
+        options.export_depth = parse_u64(program, flag, arg);
+        if (options.export_depth == 0)
+          usage(program, 1);
+      }
+      else if (strcmp(flag, "--export-bench") == 0)
+        options.export_bench = parse_u64(program, flag, arg);
+      else if (strcmp(flag, "--dump") == 0)
+        options.dump = arg;
+      else if (strcmp(flag, "--dump-format") == 0)
+      {
+        using Format = cw::serialise::Format;
+        if (strcmp(arg, "sexp") == 0)
+          options.dump_format = Format::SEXP;
+        else if (strcmp(arg, "csv") == 0)
+          options.dump_format = Format::CSV;
+        else if (strcmp(arg, "binary") == 0)
+          options.dump_format = Format::BINARY;
+        else
+          usage(program, 1);
+      }
+      else
+      {
+        fprintf(stderr, "%s: unknown option `%s`\n", program, flag);
+        usage(program, 1);
+      }
+    }
+    return options;
+  }
+} // namespace cw::options
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,82 @@
+/* options.hpp: Command line options
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <string>
+
+#include "base.hpp"
+#include "serialise.hpp"
+#include "state.hpp"
+
+namespace cw::options
+{
+  enum class FrameFormat
+  {
+    PNG,
+    PPM,
+  };
+
+  struct Options
+  {
+    // Run without a window, writing frames to frames_dir instead.
+    bool headless;
+    cw::state::DrawState::View view;
+    cw::state::DrawState::Colouring colouring;
+    u64 frame_every;
+    // Stop once this many nodes have been generated (0 for never).
+    u64 max_nodes;
+    std::string frames_dir;
+    FrameFormat frame_format;
+    // Answer queries here instead of drawing anything (see query.hpp): "-"
+    // for stdin/stdout or a Unix socket path.  Empty for no.
+    std::string serve;
+    // Carry on from the checkpoint here if there is one, and leave one here
+    // on the way out.  Empty for no.
+    std::string checkpoint;
+    // Save the checkpoint compactly (see compact.hpp) rather than raw.
+    bool compact_checkpoint;
+    // Check every shard of a raw checkpoint against its checksum before
+    // carrying on from it.
+    bool verify_checkpoint;
+    // Journal every batch of nodes here, durably, and replay it on startup.
+    // Emptied whenever a checkpoint is saved.  Empty for no.
+    std::string journal;
+    // Stream every node out here as it's generated (see exporter.hpp),
+    // through export_depth buffers.  Empty for no.
+    std::string export_to;
+    u64 export_depth;
+    // Instead of anything else, time exporting this many nodes to export_to
+    // with each backend.  0 for no.
+    u64 export_bench;
+    // Write the whole tree here on the way out, in dump_format: "-" for
+    // stdout.  Empty for no.
+    std::string dump;
+    cw::serialise::Format dump_format;
+
+    Options(void);
+  };
+
+  // Parse argv into Options.  Prints usage and exits on bad input.
+  Options parse(int argc, char *argv[]);
+} // namespace cw::options
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,87 @@
+/* parallel.hpp: Tiny helpers for splitting work across threads
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <thread>
+#include <vector>
+
+#include "base.hpp"
+
+namespace cw::parallel
+{
+  inline u64 n_threads(void)
+  {
+    u64 n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+  }
+
+  // Split [begin, end) into contiguous chunks of at least `grain` elements and
+  // call f(chunk_begin, chunk_end) on each, one thread per chunk.  The calling
+  // thread takes the first chunk, so small ranges never spawn anything.
+  template <typename F>
+  void for_range(u64 begin, u64 end, F &&f, u64 grain = 1 << 14)
+  {
+    if (end <= begin)
+      return;
+    const u64 size    = end - begin;
+    const u64 threads = MIN(n_threads(), (size + grain - 1) / grain);
+    if (threads <= 1)
+    {
+      f(begin, end);
+      return;
+    }
+
+    const u64 chunk = (size + threads - 1) / threads;
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (u64 i = 1; i < threads; ++i)
+    {
+      u64 chunk_begin = begin + (i * chunk);
+      u64 chunk_end   = MIN(end, chunk_begin + chunk);
+      if (chunk_begin >= chunk_end)
+        break;
+      pool.emplace_back([&f, chunk_begin, chunk_end]() {
+        f(chunk_begin, chunk_end);
+      });
+    }
+    f(begin, MIN(end, begin + chunk));
+    for (auto &thread : pool)
+      thread.join();
+  }
+
+  // Call f(i) for each i in [0, n), one thread each, the calling thread
+  // taking i = 0.  For when each chunk needs to know which it is.
+  template <typename F>
+  void for_chunks(u64 n, F &&f)
+  {
+    std::vector<std::thread> pool;
+    pool.reserve(n > 0 ? n - 1 : 0);
+    for (u64 i = 1; i < n; ++i)
+      pool.emplace_back([&f, i]() { f(i); });
+    if (n > 0)
+      f(0);
+    for (auto &thread : pool)
+      thread.join();
+  }
+} // namespace cw::parallel
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,488 @@
+/* query.cpp: Answering rank, unrank and range queries over a socket
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "node.hpp"
+#include "parallel.hpp"
+#include "query.hpp"
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "the query protocol is little endian, as is the host");
+
+namespace cw::query
+{
+  using cw::node::Fraction;
+
+  constexpr auto ACCEPT_POLL_MS = 100;
+  // Below this many operands a batch isn't worth splitting across threads.
+  constexpr u64 GRAIN = 1 << 12;
+
+  static volatile std::sig_atomic_t interrupted = 0;
+
+  static void on_signal(int)
+  {
+    interrupted = 1;
+  }
+
+  // Words per operand and per result of each op, or 0 for an unknown op.
+  static u64 operand_words(u8 op)
+  {
+    switch (static_cast<Op>(op))
+    {
+    case Op::RANK:
+      return 2;
+    case Op::UNRANK:
+      return 1;
+    case Op::RANGE:
+      return 5;
+    }
+    return 0;
+  }
+
+  static u64 result_words(u8 op)
+  {
+    return static_cast<Op>(op) == Op::UNRANK ? 2 : 1;
+  }
+
+  struct Batch
+  {
+    Header header;
+    std::vector<u64> words;
+  };
+
+  // A RANGE bound has to be a value in the tree: both parts nonzero, and
+  // reduced.  Anything else would divide by zero on the way to its key.
+  static bool valid_bound(u64 p, u64 q)
+  {
+    return p != 0 && q != 0 && std::gcd(p, q) == 1;
+  }
+
+  // Why the operands of `request` can't be answered, or OK.
+  static Status check(const Batch &request)
+  {
+    if (static_cast<Op>(request.header.op) != Op::RANGE)
+      return Status::OK;
+    for (u64 i = 0; i < request.words.size(); i += 5)
+    {
+      const u64 *in = request.words.data() + i;
+      if (!valid_bound(in[1], in[2]) || !valid_bound(in[3], in[4]))
+        return Status::BAD_OPERAND;
+    }
+    return Status::OK;
+  }
+
+  // Work out the result of one (checked) operand into `out`.
+  static void answer_one(Op op, const u64 *in, u64 *out)
+  {
+    switch (op)
+    {
+    case Op::RANK:
+      out[0] = cw::node::rank(in[0], in[1]).value_or(~0ULL);
+      break;
+    case Op::UNRANK:
+      if (in[0] == ~0ULL) // 0/0, which no Fraction can be built from
+        out[0] = out[1] = 0;
+      else
+      {
+        Fraction f = cw::node::unrank(in[0]);
+        out[0]     = f.numerator;
+        out[1]     = f.denominator;
+      }
+      break;
+    case Op::RANGE:
+      out[0] = cw::node::count_range(MIN(in[0], (1ULL << 63) - 1),
+                                     Fraction{in[1], in[2]},
+                                     Fraction{in[3], in[4]});
+      break;
+    }
+  }
+
+  static bool read_full(int fd, void *buffer, u64 size)
+  {
+    u8 *bytes = static_cast<u8 *>(buffer);
+    while (size > 0)
+    {
+      ssize_t got = read(fd, bytes, size);
+      if (got < 0 && errno == EINTR)
+        continue;
+      if (got <= 0)
+        return false;
+      bytes += got;
+      size -= got;
+    }
+    return true;
+  }
+
+  static bool write_full(int fd, const void *buffer, u64 size)
+  {
+    const u8 *bytes = static_cast<const u8 *>(buffer);
+    while (size > 0)
+    {
+      ssize_t put = write(fd, bytes, size);
+      if (put < 0 && errno == EINTR)
+        continue;
+      if (put <= 0)
+        return false;
+      bytes += put;
+      size -= put;
+    }
+    return true;
+  }
+
+  struct Pipeline;
+
+  // A batch on its way through a connection's pipeline.
+  struct Job
+  {
+    Batch request, response;
+    Pipeline *pipeline;
+    u64 remaining; // chunks not answered yet, under the pipeline's mutex
+  };
+
+  // Operands [begin, end) of a job, for the pool.
+  struct Chunk
+  {
+    Job *job;
+    u64 begin, end;
+  };
+
+  // Answers chunks of every connection's batches, a thread per core for as
+  // long as the server runs, rather than threads started per batch.
+  struct Pool
+  {
+    Pool(void)
+    {
+      for (u64 i = 0; i < parallel::n_threads(); ++i)
+        threads.emplace_back([this]() { run(); });
+    }
+
+    ~Pool(void)
+    {
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+      }
+      ready.notify_all();
+      for (auto &thread : threads)
+        thread.join();
+    }
+
+    // Queue operands [0, count) of `job`, in chunks of GRAIN.
+    void push(Job *job, u64 count);
+
+  private:
+    void run(void);
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Chunk> chunks;
+    bool stopping = false;
+    std::vector<std::thread> threads;
+  };
+
+  static Pool &pool(void)
+  {
+    static Pool instance;
+    return instance;
+  }
+
+  // Responses in request order, at most PIPELINE_DEPTH of them in flight.
+  struct Pipeline
+  {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::unique_ptr<Job>> jobs;
+    bool closed = false; // the reader has nothing more to send
+    bool failed = false; // the writer has given up
+
+    // Queue `request` to be answered, or straight back if it's an error.
+    // False if the writer has given up, so there's no point reading on.
+    bool push(Batch &&request)
+    {
+      auto job       = std::make_unique<Job>();
+      job->request   = std::move(request);
+      Header &header = job->request.header;
+      if (header.status != static_cast<u8>(Status::OK))
+        header.count = 0;
+      job->response.header = header;
+      job->response.words.resize(header.count * result_words(header.op));
+      job->pipeline  = this;
+      job->remaining = (header.count + GRAIN - 1) / GRAIN;
+
+      // Once it's queued, a job with nothing to answer can be written back
+      // and freed at any moment: nothing past here may look at it.
+      const u64 count = header.count;
+      Job *raw        = job.get();
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        changed.wait(lock, [&] {
+          return failed || jobs.size() < PIPELINE_DEPTH;
+        });
+        if (failed)
+          return false;
+        jobs.push_back(std::move(job));
+      }
+      if (count > 0)
+        pool().push(raw, count);
+      return true;
+    }
+
+    // The next job, once it's been answered, or nullptr once they're all
+    // done with.
+    std::unique_ptr<Job> pop(void)
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      changed.wait(lock, [&] {
+        return jobs.empty() ? closed : jobs.front()->remaining == 0;
+      });
+      if (jobs.empty())
+        return nullptr;
+      std::unique_ptr<Job> job = std::move(jobs.front());
+      jobs.pop_front();
+      changed.notify_all();
+      return job;
+    }
+
+    void answered(Job *job)
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (--job->remaining == 0)
+        changed.notify_all();
+    }
+
+    // Let the writer know there's nothing more to come.
+    void close(void)
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      closed = true;
+      changed.notify_all();
+    }
+
+    void fail(void)
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      failed = true;
+      changed.notify_all();
+    }
+  };
+
+  void Pool::push(Job *job, u64 count)
+  {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      for (u64 begin = 0; begin < count; begin += GRAIN)
+        chunks.push_back(Chunk{job, begin, MIN(count, begin + GRAIN)});
+    }
+    ready.notify_all();
+  }
+
+  void Pool::run(void)
+  {
+    while (true)
+    {
+      Chunk chunk;
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        ready.wait(lock, [&] { return stopping || !chunks.empty(); });
+        if (chunks.empty())
+          return;
+        chunk = chunks.front();
+        chunks.pop_front();
+      }
+      Job &job           = *chunk.job;
+      const u8 op        = job.request.header.op;
+      const u64 in_words = operand_words(op), out_words = result_words(op);
+      for (u64 i = chunk.begin; i < chunk.end; ++i)
+        answer_one(static_cast<Op>(op),
+                   job.request.words.data() + (i * in_words),
+                   job.response.words.data() + (i * out_words));
+      job.pipeline->answered(&job);
+    }
+  }
+
+  void serve_stream(int in_fd, int out_fd)
+  {
+    Pipeline pipeline;
+    std::thread writer{[&]() {
+      // Even after giving up, every job is waited for: the pool may still
+      // be answering them.
+      bool writing = true;
+      while (std::unique_ptr<Job> job = pipeline.pop())
+      {
+        const Batch &batch = job->response;
+        if (writing &&
+            !(write_full(out_fd, &batch.header, sizeof(batch.header)) &&
+              write_full(out_fd, batch.words.data(),
+                         batch.words.size() * sizeof(u64))))
+        {
+          writing = false;
+          pipeline.fail();
+        }
+      }
+    }};
+
+    Batch request;
+    while (read_full(in_fd, &request.header, sizeof(request.header)))
+    {
+      Header &header = request.header;
+      header.status  = static_cast<u8>(Status::OK);
+      if (operand_words(header.op) == 0 || header.count > QUERY_MAX_BATCH)
+      {
+        header.status = static_cast<u8>(operand_words(header.op) == 0
+                                            ? Status::BAD_OP
+                                            : Status::TOO_LARGE);
+        pipeline.push(std::move(request));
+        break;
+      }
+
+      request.words.resize(header.count * operand_words(header.op));
+      if (!read_full(in_fd, request.words.data(),
+                     request.words.size() * sizeof(u64)))
+        break;
+      header.status   = static_cast<u8>(check(request));
+      const bool good = header.status == static_cast<u8>(Status::OK);
+      if (!pipeline.push(std::move(request)) || !good)
+        break;
+      request = Batch{};
+    }
+
+    pipeline.close();
+    writer.join();
+  }
+
+  // A socket connection, served on its own thread.  The fd is only closed
+  // once the thread is done with it, so shutting it down from the accepting
+  // thread (to hurry it along) never hits some other file.
+  struct Connection
+  {
+    int fd;
+    std::atomic<bool> done;
+    std::thread thread;
+  };
+
+  static bool serve_socket(const std::string &path)
+  {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+      fprintf(stderr, "query: socket path `%s` is too long\n", path.c_str());
+      return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // Clear out a socket left behind by an earlier server, but nothing else.
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+      unlink(path.c_str());
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 ||
+        bind(listen_fd, reinterpret_cast<const sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0)
+    {
+      fprintf(stderr, "query: can't listen on `%s`: %s\n", path.c_str(),
+              strerror(errno));
+      if (listen_fd >= 0)
+        close(listen_fd);
+      return false;
+    }
+    fprintf(stderr, "query: listening on %s\n", path.c_str());
+
+    interrupted = 0;
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    auto reap = [&](bool all) {
+      for (auto it = connections.begin(); it != connections.end();)
+      {
+        Connection &connection = **it;
+        if (all)
+          shutdown(connection.fd, SHUT_RDWR);
+        if (!all && !connection.done)
+        {
+          ++it;
+          continue;
+        }
+        connection.thread.join();
+        close(connection.fd);
+        it = connections.erase(it);
+      }
+    };
+
+    pollfd listener{listen_fd, POLLIN, 0};
+    while (!interrupted)
+    {
+      reap(false);
+      if (poll(&listener, 1, ACCEPT_POLL_MS) <= 0)
+        continue;
+      int fd = accept(listen_fd, nullptr, nullptr);
+      if (fd < 0)
+        continue;
+      auto connection = std::make_unique<Connection>();
+      connection->fd  = fd;
+      connection->done = false;
+      Connection *raw = connection.get();
+      connection->thread = std::thread{[raw]() {
+        serve_stream(raw->fd, raw->fd);
+        raw->done = true;
+      }};
+      connections.push_back(std::move(connection));
+    }
+
+    reap(true);
+    close(listen_fd);
+    unlink(path.c_str());
+    return true;
+  }
+
+  bool serve(const std::string &path)
+  {
+    // A client hanging up mid-response is its own business, not a reason to
+    // take the whole server down.
+    std::signal(SIGPIPE, SIG_IGN);
+    if (path == "-")
+    {
+      serve_stream(STDIN_FILENO, STDOUT_FILENO);
+      return true;
+    }
+    return serve_socket(path);
+  }
+} // namespace cw::query
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,91 @@
+/* query.hpp: Answering rank, unrank and range queries over a socket
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include <string>
+
+#include "base.hpp"
+
+namespace cw::query
+{
+  // The whole tree is computable from indices (see node.hpp), so a server
+  // needs nothing resident beyond the code: no generation, no allocator.
+  //
+  // The protocol is batches of fixed size records, every field little
+  // endian.  A request is a Header followed by `count` operands; the
+  // response to it is a Header (same op) followed by `count` results, or by
+  // nothing if status isn't OK.  Responses come back in the order their
+  // requests were sent, so clients can send as many batches as they like
+  // before reading anything back.  Operands and results, in u64 words:
+  //   RANK:   p, q -> index, or ~0 if p/q isn't in the tree (or past depth 63)
+  //   UNRANK: index -> p, q (0/0 for index ~0)
+  //   RANGE:  count, lower p, lower q, upper p, upper q -> number of the first
+  //           count nodes with values in [lower, upper] (count below 2^63);
+  //           both bounds must be in the tree, else BAD_OPERAND
+  // A bad request gets a response with an error status, after which the
+  // connection is closed as there's no telling where the next request
+  // starts.
+  enum class Op : u8
+  {
+    RANK   = 1,
+    UNRANK = 2,
+    RANGE  = 3,
+  };
+
+  enum class Status : u8
+  {
+    OK          = 0,
+    BAD_OP      = 1, // op isn't one of the above
+    TOO_LARGE   = 2, // count is over QUERY_MAX_BATCH
+    BAD_OPERAND = 3, // a RANGE bound with a zero part, or not reduced
+  };
+
+  struct Header
+  {
+    u8 op, status; // status is ignored in requests
+    u16 reserved;
+    u32 count;
+  };
+
+  static_assert(sizeof(Header) == 8, "Header must be packed to 8 bytes");
+
+#ifndef QUERY_MAX_BATCH
+#define QUERY_MAX_BATCH (1 << 20)
+#endif
+
+  // Batches a connection may have read but not yet answered.  They're
+  // answered in chunks by a pool of a thread per core shared by every
+  // connection, so while one is being written back the next few are being
+  // worked out, with no threads started per batch.
+  constexpr u64 PIPELINE_DEPTH = 8;
+
+  // Serve one connection, reading requests from in_fd and writing responses
+  // to out_fd, until in_fd hits end of file or either side fails.
+  void serve_stream(int in_fd, int out_fd);
+
+  // Serve on `path`: "-" for stdin/stdout, anything else is a Unix domain
+  // socket to listen on (with any number of connections at once) until
+  // SIGINT or SIGTERM.  Returns false if the socket couldn't be set up.
+  bool serve(const std::string &path);
+} // namespace cw::query
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,98 @@
+/* radix.hpp: Parallel LSD radix sort on 64 bit keys
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef RADIX_HPP
+#define RADIX_HPP
+
+#include <utility>
+#include <vector>
+
+#include "base.hpp"
+#include "parallel.hpp"
+
+namespace cw::radix
+{
+  constexpr u64 DIGIT_BITS = 8, BUCKETS = 1 << DIGIT_BITS,
+                PASSES = 64 / DIGIT_BITS;
+
+  // Below this many elements per thread, sort on the calling thread alone.
+  constexpr u64 GRAIN = 1 << 16;
+
+  // Stable sort of data[0, n) by key(data[i]), a u64, using scratch (room for
+  // n) as the other buffer; the result ends up in data.  Each pass splits the
+  // input into one chunk per thread: every thread counts the digits in its
+  // chunk, a prefix sum over (digit, thread) gives each thread its own
+  // offsets in the output, then every thread scatters its chunk.  Passes on
+  // which every key has the same digit are skipped, so keys with few distinct
+  // bits (say, small order keys, whose low bits are all zero) cost less.
+  template <typename T, typename Key>
+  void sort(T *data, T *scratch, u64 n, Key &&key)
+  {
+    if (n < 2)
+      return;
+    const u64 threads = MIN(parallel::n_threads(), MAX(1, n / GRAIN));
+    const u64 chunk   = (n + threads - 1) / threads;
+    std::vector<u64> counts(threads * BUCKETS);
+
+    T *from = data, *to = scratch;
+    for (u64 pass = 0; pass < PASSES; ++pass)
+    {
+      const u64 shift = pass * DIGIT_BITS;
+      auto digit      = [&](const T &x) {
+        return (key(x) >> shift) & (BUCKETS - 1);
+      };
+
+      std::fill(counts.begin(), counts.end(), 0);
+      parallel::for_chunks(threads, [&](u64 t) {
+        u64 *count = counts.data() + (t * BUCKETS);
+        for (u64 i = t * chunk, end = MIN(n, i + chunk); i < end; ++i)
+          ++count[digit(from[i])];
+      });
+
+      u64 same = 0, first = digit(from[0]);
+      for (u64 t = 0; t < threads; ++t)
+        same += counts[(t * BUCKETS) + first];
+      if (same == n)
+        continue;
+
+      // Turn counts into offsets, digit major so the sort stays stable.
+      u64 offset = 0;
+      for (u64 d = 0; d < BUCKETS; ++d)
+        for (u64 t = 0; t < threads; ++t)
+        {
+          u64 count                 = counts[(t * BUCKETS) + d];
+          counts[(t * BUCKETS) + d] = offset;
+          offset += count;
+        }
+
+      parallel::for_chunks(threads, [&](u64 t) {
+        u64 *offsets = counts.data() + (t * BUCKETS);
+        for (u64 i = t * chunk, end = MIN(n, i + chunk); i < end; ++i)
+          to[offsets[digit(from[i])]++] = std::move(from[i]);
+      });
+      std::swap(from, to);
+    }
+
+    if (from != data)
+      std::move(from, from + n, data);
+  }
+} // namespace cw::radix
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
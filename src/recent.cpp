@@ -0,0 +1,52 @@
+/* recent.cpp: The most recently expanded nodes
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include "recent.hpp"
+
+namespace cw::recent
+{
+  Ring::Ring(void) : head{0}
+  {
+    for (auto &slot : slots)
+      slot.store(0, std::memory_order_relaxed);
+  }
+
+  void Ring::push(u64 generator)
+  {
+    u64 ticket = head.fetch_add(1, std::memory_order_relaxed);
+    slots[ticket & (RECENT_SIZE - 1)].store(generator + 1,
+                                            std::memory_order_release);
+  }
+
+  u64 Ring::read(u64 *out) const
+  {
+    u64 end = head.load(std::memory_order_acquire);
+    u64 n   = MIN(end, RECENT_SIZE), copied = 0;
+    for (u64 i = 1; i <= n; ++i)
+    {
+      // A slot may not have been written yet by whoever claimed it.
+      u64 slot = slots[(end - i) & (RECENT_SIZE - 1)].load(
+          std::memory_order_acquire);
+      if (slot != 0)
+        out[copied++] = slot - 1;
+    }
+    return copied;
+  }
+} // namespace cw::recent
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
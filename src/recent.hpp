@@ -0,0 +1,58 @@
+/* recent.hpp: The most recently expanded nodes
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef RECENT_HPP
+#define RECENT_HPP
+
+#include <atomic>
+
+#include "base.hpp"
+
+#ifndef RECENT_SIZE
+#define RECENT_SIZE 256
+#endif
+
+namespace cw::recent
+{
+  static_assert((RECENT_SIZE & (RECENT_SIZE - 1)) == 0,
+                "RECENT_SIZE must be a power of 2");
+
+  // Ring of the last RECENT_SIZE nodes expanded by the workers, which
+  // overwrites the oldest entry once full.  Node i's children are always
+  // nodes 2i + 1 and 2i + 2, so an expansion is just the index of its
+  // generator and fits in one atomic word: pushing is a fetch_add and a
+  // store, with no lock and no way for a reader to see half an entry.
+  struct Ring
+  {
+    std::atomic<u64> head;
+    std::atomic<u64> slots[RECENT_SIZE]; // generator index + 1, 0 if empty
+
+    Ring(void);
+
+    void push(u64 generator);
+
+    // Copy the generators currently in the ring into `out` (which must have
+    // room for RECENT_SIZE), newest first.  Returns how many were copied.
+    // Anything pushed while reading may or may not be seen.
+    u64 read(u64 *out) const;
+  };
+} // namespace cw::recent
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
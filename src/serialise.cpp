@@ -0,0 +1,275 @@
+/* serialise.cpp: Writing the tree out as text or binary, a buffer at a time
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include <unistd.h>
+
+#include "format.hpp"
+#include "serialise.hpp"
+
+namespace cw::serialise
+{
+  using cw::node::Node;
+  using cw::node::NodeAllocator;
+
+  Writer::Writer(std::ostream &stream)
+      : stream{&stream}, fd{-1}, buffer(WRITER_BUFFER), used{0}, failed{false}
+  {
+  }
+
+  Writer::Writer(int fd)
+      : stream{nullptr}, fd{fd}, buffer(WRITER_BUFFER), used{0}, failed{false}
+  {
+  }
+
+  Writer::~Writer(void)
+  {
+    flush();
+  }
+
+  bool Writer::flush(void)
+  {
+    if (failed || used == 0)
+    {
+      used = 0;
+      return !failed;
+    }
+    if (stream)
+      failed = !stream->write(buffer.data(), used);
+    else
+    {
+      const char *bytes = buffer.data();
+      u64 left          = used;
+      while (left > 0)
+      {
+        ssize_t put = ::write(fd, bytes, left);
+        if (put < 0 && errno == EINTR)
+          continue;
+        if (put <= 0)
+        {
+          failed = true;
+          break;
+        }
+        bytes += put;
+        left -= put;
+      }
+    }
+    used = 0;
+    return !failed;
+  }
+
+  bool Writer::ok(void) const
+  {
+    return !failed;
+  }
+
+  void Writer::put(char c)
+  {
+    if (used == buffer.size())
+      flush();
+    buffer[used++] = c;
+  }
+
+  void Writer::put(const char *bytes, u64 size)
+  {
+    while (size > 0)
+    {
+      if (used == buffer.size())
+        flush();
+      u64 n = MIN(size, buffer.size() - used);
+      memcpy(buffer.data() + used, bytes, n);
+      used += n;
+      bytes += n;
+      size -= n;
+    }
+  }
+
+  void Writer::put(const char *text)
+  {
+    put(text, strlen(text));
+  }
+
+  void Writer::put_u64(u64 n)
+  {
+    char digits[cw::format::U64_DIGITS];
+    put(digits, cw::format::format_u64(digits, n) - digits);
+  }
+
+  void Writer::put_i64(i64 n)
+  {
+    if (n < 0)
+      put('-');
+    // Negate as unsigned, so the most negative i64 comes out right.
+    put_u64(n < 0 ? 0 - static_cast<u64>(n) : static_cast<u64>(n));
+  }
+
+  void Writer::put_fraction(const cw::node::Fraction &f)
+  {
+    char label[cw::format::FRACTION_SIZE];
+    put(label, cw::format::format_fraction(label, f) - label);
+  }
+
+  void Writer::put_bytes(const void *bytes, u64 size)
+  {
+    put(static_cast<const char *>(bytes), size);
+  }
+
+  static void indent(Writer &out, int depth)
+  {
+    static const char SPACES[] = "                                ";
+    for (u64 n = 2 * MAX(depth, 0); n > 0;)
+    {
+      u64 chunk = MIN(n, sizeof(SPACES) - 1);
+      out.put(SPACES, chunk);
+      n -= chunk;
+    }
+  }
+
+  void write_sexp(Writer &out, const NodeAllocator &allocator, i64 root,
+                  int depth)
+  {
+    // A node at depth d comes out as
+    //   (value\n<indent d>left\n<indent d>right)
+    // so each frame remembers which of its children is next.
+    enum class Next
+    {
+      LEFT,
+      RIGHT,
+      CLOSE,
+    };
+    struct Frame
+    {
+      i64 left, right;
+      int depth;
+      Next next;
+    };
+    std::vector<Frame> stack;
+
+    // Either opens child's list (to be filled in by the frames to come) or
+    // writes NIL for it.
+    auto visit = [&](i64 child, int depth) {
+      if (child < 0)
+      {
+        out.put("NIL", 3);
+        return;
+      }
+      Node node = allocator.get_val(child);
+      out.put('(');
+      out.put_fraction(node.value);
+      out.put('\n');
+      indent(out, depth);
+      stack.push_back(Frame{node.left, node.right, depth, Next::LEFT});
+    };
+
+    visit(root, depth);
+    while (!stack.empty())
+    {
+      Frame &frame = stack.back();
+      switch (frame.next)
+      {
+      case Next::LEFT:
+        frame.next = Next::RIGHT;
+        visit(frame.left, frame.depth + 1);
+        break;
+      case Next::RIGHT:
+        out.put('\n');
+        indent(out, frame.depth);
+        frame.next = Next::CLOSE;
+        visit(frame.right, frame.depth + 1);
+        break;
+      case Next::CLOSE:
+        out.put(')');
+        stack.pop_back();
+        break;
+      }
+    }
+  }
+
+  static void write_csv(Writer &out, const NodeAllocator &allocator)
+  {
+    out.put("index,numerator,denominator,left,right\n");
+    for (u64 i = 0; i < allocator.size(); ++i)
+    {
+      Node node = allocator.get_val(i);
+      out.put_u64(i);
+      out.put(',');
+      out.put_u64(node.value.numerator);
+      out.put(',');
+      out.put_u64(node.value.denominator);
+      out.put(',');
+      out.put_i64(node.left);
+      out.put(',');
+      out.put_i64(node.right);
+      out.put('\n');
+    }
+  }
+
+  static void write_binary(Writer &out, const NodeAllocator &allocator)
+  {
+    BinaryHeader header{};
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.endian  = BINARY_ENDIAN_TAG;
+    header.version = BINARY_VERSION;
+    header.count   = allocator.size();
+    out.put_bytes(&header, sizeof(header));
+    for (u64 i = 0; i < allocator.size(); ++i)
+    {
+      Node node = allocator.get_val(i);
+      BinaryNode record{node.value.numerator, node.value.denominator,
+                        node.left, node.right};
+      out.put_bytes(&record, sizeof(record));
+    }
+  }
+
+  bool write(Writer &out, const NodeAllocator &allocator, Format format)
+  {
+    switch (format)
+    {
+    case Format::SEXP:
+      write_sexp(out, allocator, allocator.size() > 0 ? 0 : -1);
+      out.put('\n');
+      break;
+    case Format::CSV:
+      write_csv(out, allocator);
+      break;
+    case Format::BINARY:
+      write_binary(out, allocator);
+      break;
+    }
+    return out.flush();
+  }
+} // namespace cw::serialise
+
+namespace cw::node
+{
+  // Here rather than node.cpp so the tree doesn't depend on its writers.
+  std::string to_string(const NodeAllocator &allocator, const i64 n, int depth)
+  {
+    std::ostringstream ss;
+    {
+      cw::serialise::Writer out{ss};
+      cw::serialise::write_sexp(out, allocator, n, depth);
+    }
+    return ss.str();
+  }
+} // namespace cw::node
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,108 @@
+/* serialise.hpp: Writing the tree out as text or binary, a buffer at a time
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef SERIALISE_HPP
+#define SERIALISE_HPP
+
+#include <ostream>
+#include <vector>
+
+#include "base.hpp"
+#include "node.hpp"
+
+#ifndef WRITER_BUFFER
+#define WRITER_BUFFER (1 << 16)
+#endif
+
+namespace cw::serialise
+{
+  // Buffered output to either a stream or a file descriptor, handing the
+  // sink WRITER_BUFFER bytes at a time.  Memory is the buffer and nothing
+  // else, however much goes through it.  Stops writing after the first
+  // failure, which ok() and flush() report.
+  struct Writer
+  {
+    explicit Writer(std::ostream &);
+    explicit Writer(int fd);
+    ~Writer(void);
+
+    void put(char);
+    void put(const char *, u64 size);
+    void put(const char *); // null terminated
+    void put_u64(u64);
+    void put_i64(i64);
+    void put_fraction(const cw::node::Fraction &);
+    void put_bytes(const void *, u64 size);
+
+    // Hand everything buffered to the sink.  False if anything so far has
+    // failed to write.
+    bool flush(void);
+    bool ok(void) const;
+
+  private:
+    std::ostream *stream;
+    int fd;
+    std::vector<char> buffer;
+    u64 used;
+    bool failed;
+  };
+
+  enum class Format
+  {
+    // Nested (fraction left right) lists, NIL for no child, each child on
+    // its own line indented by depth: what to_string(NodeAllocator) gives.
+    SEXP,
+    // A header line, then index,numerator,denominator,left,right for every
+    // node in index order, -1 for no child.
+    CSV,
+    // BinaryHeader, then a BinaryNode for every node in index order.
+    BINARY,
+  };
+
+  constexpr char BINARY_MAGIC[8] = {'C', 'W', 'T', 'R', 'E', 'E', 'B', 'N'};
+  constexpr u32 BINARY_VERSION    = 1;
+  constexpr u32 BINARY_ENDIAN_TAG = 0x01020304;
+
+  struct BinaryHeader
+  {
+    char magic[8];
+    u32 endian, version;
+    u64 count;
+  };
+
+  struct BinaryNode
+  {
+    u64 numerator, denominator;
+    i64 left, right;
+  };
+
+  // The subtree under `root` as an S-expression, with its children indented
+  // from `depth`.  Walks the tree with an explicit stack, one frame per
+  // level, rather than recursing: output streams straight out through the
+  // writer instead of being built up in strings at each level.
+  void write_sexp(Writer &, const cw::node::NodeAllocator &, i64 root,
+                  int depth = 1);
+
+  // All of the allocator's nodes in `format` (SEXP from the root), flushed.
+  // Returns false if the writer failed.
+  bool write(Writer &, const cw::node::NodeAllocator &, Format);
+} // namespace cw::serialise
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,83 @@
+/* snapshot.cpp: Render side snapshots of the tree
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <thread>
+
+#include "snapshot.hpp"
+
+namespace cw::snapshot
+{
+  u64 Frame::count(void) const
+  {
+    return norms.size();
+  }
+
+  Pipeline::Pipeline(void) : back_index{0}, front_index{1}, middle{2}
+  {
+  }
+
+  Frame &Pipeline::back(void)
+  {
+    return frames[back_index];
+  }
+
+  void Pipeline::publish(void)
+  {
+    u8 prev    = middle.exchange(back_index | FRESH, std::memory_order_acq_rel);
+    back_index = prev & INDEX;
+  }
+
+  bool Pipeline::acquire(void)
+  {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH))
+      return false;
+    u8 prev     = middle.exchange(front_index, std::memory_order_acq_rel);
+    front_index = prev & INDEX;
+    return true;
+  }
+
+  const Frame &Pipeline::front(void) const
+  {
+    return frames[front_index];
+  }
+
+  void snapshotter(State &state, Pipeline &pipeline)
+  {
+    u64 published = 0;
+    while (!state.stop_work)
+    {
+      std::this_thread::sleep_for(SNAPSHOT_DELAY);
+
+      Frame &frame = pipeline.back();
+      state.mutex.lock();
+      u64 count = state.allocator.size();
+      for (u64 i = frame.count(); i < count; ++i)
+        frame.norms.push_back(state.allocator.get_val(i).value.norm);
+      state.mutex.unlock();
+
+      if (count > published)
+      {
+        frame.index = state.index.latest();
+        pipeline.publish();
+        published = count;
+      }
+    }
+  }
+} // namespace cw::snapshot
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -0,0 +1,87 @@
+/* snapshot.hpp: Render side snapshots of the tree
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "base.hpp"
+#include "index.hpp"
+#include "state.hpp"
+
+#ifndef SNAPSHOT_MS
+#define SNAPSHOT_MS 5
+#endif
+
+namespace cw::snapshot
+{
+  using cw::state::State;
+  constexpr auto SNAPSHOT_DELAY = std::chrono::milliseconds(SNAPSHOT_MS);
+
+  // Everything the renderer needs to know about the tree at some point.
+  struct Frame
+  {
+    // norms[i] is the value of the node at BFS index i.
+    std::vector<f64> norms;
+    // Nodes in value order, for picking and the like.  May be a little behind
+    // or ahead of norms, as it's fed by the workers directly.
+    std::shared_ptr<const cw::index::Version> index;
+
+    u64 count(void) const;
+  };
+
+  // Triple buffer of frames between one producer (snapshotter) and one
+  // consumer (the renderer).  The producer fills its back frame and swaps it
+  // with the middle one; the consumer swaps its front frame with the middle
+  // one whenever the middle is fresh.  Neither side ever waits on the other,
+  // and neither touches State.
+  struct Pipeline
+  {
+    Frame frames[3];
+
+    Pipeline(void);
+
+    // Producer: the frame to fill, and publishing it once filled.
+    Frame &back(void);
+    void publish(void);
+
+    // Consumer: pick up the latest published frame if there is one.  Returns
+    // true if front() changed.
+    bool acquire(void);
+    const Frame &front(void) const;
+
+  private:
+    static constexpr u8 FRESH = 1 << 2, INDEX = FRESH - 1;
+    u8 back_index, front_index;
+    // Index of the middle frame, with FRESH set if it's yet to be acquired.
+    std::atomic<u8> middle;
+  };
+
+  // Steady living thread which copies newly generated nodes out of state into
+  // the pipeline's back frame and publishes it, along with the latest version
+  // of the value index.  The state mutex is only held while copying nodes the
+  // back frame hasn't seen yet.  Stops when state.stop_work is true.
+  void snapshotter(State &state, Pipeline &pipeline);
+} // namespace cw::snapshot
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -10,19 +10,26 @@
 
 namespace cw::state
 {
-  void DrawState::compute_bounds()
+  // Node at `index` along with its children, if they're within the first
+  // `count` nodes.
+  static cw::node::Node spine_node(u64 index, u64 count)
   {
-    state.mutex.lock();
-    bounds.leftmost = state.allocator.get_val(0);
-    while (bounds.leftmost.left >= 0)
-      bounds.leftmost = state.allocator.get_val(bounds.leftmost.left);
-
-    bounds.rightmost = state.allocator.get_val(0);
-    while (bounds.rightmost.right >= 0)
-      bounds.rightmost = state.allocator.get_val(bounds.rightmost.right);
-    state.mutex.unlock();
+    i64 left  = (2 * index) + 1 < count ? (2 * index) + 1 : -1;
+    i64 right = (2 * index) + 2 < count ? (2 * index) + 2 : -1;
+    return cw::node::Node{cw::node::unrank(index), left, right};
+  }
 
-    bounds.upper_val = std::ceill(bounds.rightmost.value.norm);
+  void DrawState::compute_bounds(u64 count)
+  {
+    u64 leftmost = 0, rightmost = 0;
+    while ((2 * leftmost) + 1 < count)
+      leftmost = (2 * leftmost) + 1;
+    while ((2 * rightmost) + 2 < count)
+      rightmost = (2 * rightmost) + 2;
+
+    bounds.leftmost  = spine_node(leftmost, count);
+    bounds.rightmost = spine_node(rightmost, count);
+    bounds.upper_val = std::ceil(bounds.rightmost.value.norm);
   }
 } // namespace cw::state
 
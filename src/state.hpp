@@ -9,17 +9,35 @@
 #define STATE_HPP
 
 #include <mutex>
-#include <queue>
 
 #include "base.hpp"
+#include "exporter.hpp"
+#include "farey.hpp"
+#include "gaps.hpp"
+#include "index.hpp"
+#include "journal.hpp"
 #include "node.hpp"
+#include "recent.hpp"
 
 namespace cw::state
 {
   struct State
   {
+    // Generation is breadth first, each node's children allocated together,
+    // so the work queue is always nodes [(n - 1)/2, n) of n: there's no need
+    // to keep it.  See next_parent().
     cw::node::NodeAllocator allocator;
-    std::queue<u64> queue;
+    // All fed outside of the mutex.
+    cw::recent::Ring recent;
+    cw::index::OrderedIndex index;
+    cw::gaps::Tracker gaps;
+    cw::farey::Coverage farey;
+    // Closed unless asked for, in which case every batch the index gets is
+    // journalled first.
+    cw::journal::Journal journal;
+    // Likewise, every batch goes out to the export if one's open, without
+    // waiting for it to be written.
+    cw::exporter::Exporter exporter;
 
     bool pause_work, stop_work;
     std::mutex mutex;
@@ -27,22 +45,61 @@ namespace cw::state
     State(void) {};
   };
 
+  // Node to get children next, at n and n + 1, with n nodes so far (which
+  // must be at least one).
+  inline u64 next_parent(u64 n)
+  {
+    return (n - 1) / 2;
+  }
+
+  // Children of node i of n: the nodes before next_parent(n) have both, and
+  // the rest none.
+  inline i64 implied_left(u64 i, u64 n)
+  {
+    return i < next_parent(n) ? static_cast<i64>((2 * i) + 1) : -1;
+  }
+
+  inline i64 implied_right(u64 i, u64 n)
+  {
+    return i < next_parent(n) ? static_cast<i64>((2 * i) + 2) : -1;
+  }
+
   struct DrawState
   {
-    State &state;
     struct Bounds
     {
       cw::node::Node leftmost, rightmost;
       f64 lower_val, upper_val;
     } bounds;
 
-    DrawState(State &state) : state{state}
+    enum class View
+    {
+      NUMBER_LINE,
+      GRAPH,
+      // Number line of every fraction in view, generated or not.
+      DEEP_ZOOM,
+    } view;
+
+    // What decides the colour of each node.
+    enum class Colouring
+    {
+      PLAIN,    // all red
+      DEPTH,    // depth in the tree
+      RECENCY,  // how recently it was generated
+      POSITION, // position on the number line
+    } colouring;
+
+    DrawState(void) : view{View::NUMBER_LINE}, colouring{Colouring::PLAIN}
     {
       // lim n -> -∞
       bounds.lower_val = 0;
+      bounds.upper_val = 1;
     };
 
-    void compute_bounds(void);
+    // Compute bounds for the first `count` nodes of the tree.  The extreme
+    // nodes are the ends of the left and right spines, whose indices are 2^k -
+    // 1 and 2^(k + 1) - 2, so this never looks at the tree itself.
+    void compute_bounds(u64 count);
   };
 } // namespace cw::state
 
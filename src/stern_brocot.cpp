@@ -0,0 +1,166 @@
+/* stern_brocot.cpp: Walking the tree in numeric order
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#include <cmath>
+
+#include "stern_brocot.hpp"
+
+namespace cw::node
+{
+  // A subtree of the Stern-Brocot tree: its root is the mediant of the bounds
+  // (lp/lq, rp/rq), with 0/1 and 1/0 standing in for 0 and ∞.
+  struct Subtree
+  {
+    u64 lp, lq, rp, rq, depth;
+
+    u64 p(void) const
+    {
+      return lp + rp;
+    }
+
+    u64 q(void) const
+    {
+      return lq + rq;
+    }
+
+    f64 norm(void) const
+    {
+      return static_cast<f64>(p()) / q();
+    }
+
+    f64 lower(void) const
+    {
+      return static_cast<f64>(lp) / lq;
+    }
+
+    f64 upper(void) const
+    {
+      return rq == 0 ? INFINITY : static_cast<f64>(rp) / rq;
+    }
+
+    Subtree left(void) const
+    {
+      return Subtree{lp, lq, p(), q(), depth + 1};
+    }
+
+    Subtree right(void) const
+    {
+      return Subtree{p(), q(), rp, rq, depth + 1};
+    }
+
+    // `steps` steps left (or right) at once: a whole run of the path, moving
+    // the other bound `steps` times towards this one.
+    Subtree left(u64 steps) const
+    {
+      return Subtree{lp, lq, (steps * lp) + rp, (steps * lq) + rq,
+                     depth + steps};
+    }
+
+    Subtree right(u64 steps) const
+    {
+      return Subtree{lp + (steps * rp), lq + (steps * rq), rp, rq,
+                     depth + steps};
+    }
+  };
+
+  // Largest n such that holds(i) for every i in [1, n], where holds is true
+  // up to some point and false after: gallop out, then bisect back.  O(log n)
+  // tests, so a run of n steps costs about as much as its length in bits.
+  template <typename F>
+  static u64 run_length(F &&holds)
+  {
+    u64 n = 0, stride = 1;
+    while (holds(n + stride))
+    {
+      n += stride;
+      stride *= 2;
+    }
+    while (stride > 1)
+    {
+      stride /= 2;
+      if (holds(n + stride))
+        n += stride;
+    }
+    return n;
+  }
+
+  u64 enumerate_interval(f64 lower, f64 upper, u64 max_depth,
+                         u64 max_denominator, u64 limit,
+                         std::vector<Located> &out)
+  {
+    if (limit == 0 || upper < lower || upper <= 0)
+      return 0;
+
+    // Head straight down to the smallest subtree covering the whole interval,
+    // a run at a time: the path there follows the partial quotients of the
+    // bounds for as long as they agree.  Each run goes on for as long as the
+    // node it reaches is within the limits and still on the same side of the
+    // interval.
+    auto within = [&](const Subtree &s) {
+      return s.depth < max_depth && s.q() <= max_denominator;
+    };
+    Subtree node{0, 1, 1, 0, 0};
+    while (within(node))
+    {
+      f64 x = node.norm();
+      if (upper < x)
+        node = node.left(1 + run_length([&](u64 n) {
+                             Subtree s = node.left(n);
+                             return within(s) && upper < s.norm();
+                           }));
+      else if (lower > x)
+        node = node.right(1 + run_length([&](u64 n) {
+                              Subtree s = node.right(n);
+                              return within(s) && lower > s.norm();
+                            }));
+      else
+        break;
+    }
+
+    // Then an in-order walk, pruning every subtree outside the interval or
+    // beyond the limits.  Denominators only grow going down, so a subtree
+    // whose root is over max_denominator has nothing to offer.
+    u64 found = 0;
+    std::vector<Subtree> stack;
+    auto descend_left = [&](Subtree s) {
+      while (s.depth <= max_depth && s.q() <= max_denominator &&
+             s.upper() > lower && s.lower() < upper)
+      {
+        stack.push_back(s);
+        s = s.left();
+      }
+    };
+
+    descend_left(node);
+    while (!stack.empty() && found < limit)
+    {
+      Subtree s = stack.back();
+      stack.pop_back();
+      f64 x = s.norm();
+      if (x >= lower && x <= upper)
+      {
+        out.push_back(Located{Fraction{s.p(), s.q()}, s.depth});
+        ++found;
+      }
+      descend_left(s.right());
+    }
+    return found;
+  }
+} // namespace cw::node
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
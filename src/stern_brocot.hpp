@@ -0,0 +1,51 @@
+/* stern_brocot.hpp: Walking the tree in numeric order
+ * Created: 2026-10-18
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ */
+
+#ifndef STERN_BROCOT_HPP
+#define STERN_BROCOT_HPP
+
+#include <vector>
+
+#include "base.hpp"
+#include "node.hpp"
+
+namespace cw::node
+{
+  // Level d of the Stern-Brocot tree holds exactly the same fractions as
+  // level d of the Calkin-Wilf tree, but an in-order walk of it visits them
+  // in numeric order.  Every subtree covers an open interval bounded by two
+  // of its ancestors, so we can skip any subtree which can't intersect an
+  // interval without ever looking inside it.
+
+  struct Located
+  {
+    Fraction value;
+    u64 depth;
+  };
+
+  // Append every fraction in [lower, upper] at depth at most max_depth and
+  // with denominator at most max_denominator to out, in increasing order,
+  // stopping after `limit` of them.  Returns the number appended.
+  u64 enumerate_interval(f64 lower, f64 upper, u64 max_depth,
+                         u64 max_denominator, u64 limit,
+                         std::vector<Located> &out);
+} // namespace cw::node
+
+#endif
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
@@ -16,54 +16,81 @@ namespace cw::worker
   using cw::node::Fraction;
   using cw::node::Node;
 
-  void do_iteration(State &state)
+  // Hand a batch of new nodes over to the journal, the export, the gap
+  // tracker and the value index.
+  static void flush(State &state, cw::index::Run &batch)
+  {
+    state.journal.append(batch.data(), batch.size());
+    state.exporter.append(batch.data(), batch.size());
+    state.gaps.insert(batch.data(), batch.size());
+    state.index.insert(std::move(batch));
+    batch.clear();
+    batch.reserve(INDEX_BATCH + 2);
+  }
+
+  void do_iteration(State &state, cw::index::Run &batch)
   {
     state.mutex.lock();
-    if (state.queue.empty())
+    if (state.allocator.size() == 0)
     {
       // Unlock since there isn't any work to be done.
       state.mutex.unlock();
       return;
     }
-    u64 index = state.queue.front();
-    state.queue.pop();
+    // The front of the work queue, which has no children yet: they'll be
+    // the next two allocated.
+    u64 index = cw::state::next_parent(state.allocator.size());
 
     Node node = state.allocator.get_val(index);
 
-    i64 left = node.left, right = node.right;
-    if (left < 0)
-    {
-      left = state.allocator.alloc(Fraction{
-          node.value.numerator, node.value.numerator + node.value.denominator});
-    }
-    if (right < 0)
-    {
-      right = state.allocator.alloc(
-          Fraction{node.value.numerator + node.value.denominator,
-                   node.value.denominator});
-    }
+    const u64 first_new = batch.size();
+    Fraction left_value{node.value.numerator,
+                        node.value.numerator + node.value.denominator};
+    const i64 left = state.allocator.alloc(Fraction{left_value});
+    batch.push_back({left_value.numerator, left_value.denominator,
+                     cw::node::key_of_index(left)});
+
+    Fraction right_value{node.value.numerator + node.value.denominator,
+                         node.value.denominator};
+    const i64 right = state.allocator.alloc(Fraction{right_value});
+    batch.push_back({right_value.numerator, right_value.denominator,
+                     cw::node::key_of_index(right)});
 
     Node &node_ref = state.allocator.get_ref(index);
     node_ref.left  = left;
     node_ref.right = right;
-
-    state.queue.push(left);
-    state.queue.push(right);
     state.mutex.unlock();
+
+    state.recent.push(index);
+    for (u64 i = first_new; i < batch.size(); ++i)
+    {
+      const cw::index::Entry &entry = batch[i];
+      state.farey.record(entry.numerator, entry.denominator, entry.index());
+    }
+    if (batch.size() >= INDEX_BATCH)
+      flush(state, batch);
   }
 
   void worker(State &state)
   {
+    cw::index::Run batch;
+    flush(state, batch);
     while (!state.stop_work)
     {
       std::this_thread::sleep_for(THREAD_GENERAL_DELAY);
+      if (state.pause_work)
+      {
+        // Don't sit on nodes the index hasn't seen while paused.
+        flush(state, batch);
+      }
       while (state.pause_work)
       {
         std::this_thread::sleep_for(THREAD_PAUSE_DELAY);
       }
 
-      do_iteration(state);
+      do_iteration(state, batch);
     }
+    flush(state, batch);
   }
 } // namespace cw::worker
 
@@ -19,6 +19,10 @@
 #ifndef THREAD_GENERAL_MS
 #define THREAD_GENERAL_MS 10
 #endif
+// Nodes each worker generates before feeding them to the value index.
+#ifndef INDEX_BATCH
+#define INDEX_BATCH 1024
+#endif
 
 namespace cw::worker
 {
@@ -35,7 +39,10 @@ namespace cw::worker
   // 3) push the indices of the children onto the iteration queue
   // Each step will block on the relevant mutex for the resource (1,3 will block
   // on the queue mutex, 2 will block on the allocator mutex) so is thread safe.
-  void do_iteration(State &state);
+  // New nodes go straight into the gap and Farey trackers, and are added to
+  // `batch`, which is fed to the value index once it holds INDEX_BATCH of
+  // them.
+  void do_iteration(State &state, cw::index::Run &batch);
 
   // Steady living thread worker which performs iterations.  If state.pause_work
   // is true, thread will pause until otherwise.
@@ -0,0 +1,71 @@
+#!/usr/bin/env sh
+# compact.sh: Check restore refuses compact checkpoints with bad values
+#
+# Usage: sh tests/compact.sh [BINARY]   (default ./cw_tree.out)
+#
+# Each checkpoint is built byte by byte (little endian): a header for one
+# node, then one NODES block overriding its value.  The block checksums are
+# worked out ahead of time from checksum.hpp, since restore checks them
+# before it looks at the records.  Fails if restore doesn't print what's
+# expected on stderr (so a crash or a sanitiser's report fails too).
+# check runs at the end of a pipe, in a subshell, so failures are marked
+# with a file rather than a variable.
+
+BINARY=${1:-./cw_tree.out}
+DIR=$(mktemp -d)
+
+byte() { printf "\\$(printf %03o $(($1 & 255)))"; }
+
+word() # count value: the low `count` bytes of value
+{
+    n=$2
+    i=0
+    while [ $i -lt $1 ]
+    do
+        byte $n
+        n=$((n >> 8))
+        i=$((i + 1))
+    done
+}
+
+# A compact checkpoint of one node whose value is given by a single NODES
+# record: index delta 0, flags VALUE, numerator, denominator (each under
+# 128, so one byte).  The checksum is given as its high and low halves, as
+# shell arithmetic can't hold all of it.
+checkpoint() # numerator denominator checksum-high checksum-low
+{
+    printf CWTREECP; word 4 0x01020304; word 4 1
+    word 8 1; word 8 1; word 4 -1; word 4 -1; word 8 1
+    word 4 0x424b4343; word 4 1; word 4 1; word 4 4; word 4 $4; word 4 $3
+    byte 0; byte 1; byte $1; byte $2
+}
+
+check() # name expected-stderr, checkpoint on stdin
+{
+    cat >"$DIR/cw.ck"
+    "$BINARY" --headless --checkpoint "$DIR/cw.ck" --max-nodes 3 \
+              --frame-every 100000000 --frames-dir "$DIR" \
+              >/dev/null 2>"$DIR/errors"
+    got=$(cat "$DIR/errors")
+    if [ "$got" != "$2" ]
+    then
+        echo "FAIL $1"
+        echo "  expected $2"
+        sed 's/^/  stderr: /' "$DIR/errors"
+        touch "$DIR/failed"
+    else
+        echo "ok   $1"
+    fi
+}
+
+BAD="checkpoint: \`$DIR/cw.ck\`: bad value"
+
+checkpoint 0 0 0x8b277aac 0xc6a4e304 | check "0/0 value is refused" "$BAD"
+checkpoint 2 2 0x23928270 0xaf784e61 | check "2/2 value is refused" "$BAD"
+checkpoint 1 0 0x1ad11c90 0x80481e0b | check "1/0 value is refused" "$BAD"
+checkpoint 1 1 0xc2b0d494 0xf2d5d169 | check "1/1 value restores" ""
+
+FAILED=0
+[ -e "$DIR/failed" ] && FAILED=1
+rm -rf "$DIR"
+exit $FAILED
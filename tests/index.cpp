@@ -0,0 +1,168 @@
+/* index.cpp: Check the value index's runs stay few whatever the batches
+ * Created: 2026-10-19
+ * Author: Aryadev Chavali
+ * License: See end of file
+ * Commentary:
+ *
+ * Usage: index.out
+ *
+ * Feeds cw::index::OrderedIndex batches of awkward sizes (shrinking by one
+ * at a time, then uneven) and checks after every merge that each run is
+ * sorted, at least twice the size of the next, that there are at most
+ * log2(n) + 1 of them, and that no cascade is more than twice the size of
+ * its run.  Then checks nearest() and above() against a scan of every
+ * entry, now and then along the way as well as at the end.  Prints what
+ * went wrong and exits 1 on failure.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "index.hpp"
+
+using cw::index::Entry;
+using cw::index::Run;
+
+// Node i of the Calkin-Wilf tree, walking down from 1/1 along the bits of
+// i + 1 below its top one: 0 for the left child, 1 for the right.
+static Entry entry_of(u64 i)
+{
+  u64 p = 1, q = 1;
+  for (int bit = 62 - __builtin_clzll(i + 1); bit >= 0; --bit)
+    if (((i + 1) >> bit) & 1)
+      p += q;
+    else
+      q += p;
+  return Entry{p, q, cw::node::key_of_index(i)};
+}
+
+static bool check_runs(const cw::index::Version &version, u64 inserted)
+{
+  const auto &runs = version.runs;
+  const u64 limit  = 64 - __builtin_clzll(inserted); // floor(log2) + 1
+  if (version.size() != inserted)
+  {
+    fprintf(stderr, "index: %lu entries after inserting %lu\n",
+            version.size(), inserted);
+    return false;
+  }
+  if (runs.size() > limit)
+  {
+    fprintf(stderr, "index: %lu runs for %lu entries (at most %lu)\n",
+            runs.size(), inserted, limit);
+    return false;
+  }
+  for (u64 r = 0; r < runs.size(); ++r)
+  {
+    const Run &run = runs[r]->entries;
+    if (!std::is_sorted(run.begin(), run.end()))
+    {
+      fprintf(stderr, "index: run %lu isn't sorted\n", r);
+      return false;
+    }
+    if (r + 1 < runs.size() && run.size() < 2 * runs[r + 1]->entries.size())
+    {
+      fprintf(stderr, "index: run %lu of %lu is followed by one of %lu\n", r,
+              run.size(), runs[r + 1]->entries.size());
+      return false;
+    }
+    // Plus one for the past-the-end bridge.
+    if (runs[r]->cascade.size() > (2 * run.size()) + 1)
+    {
+      fprintf(stderr, "index: run %lu of %lu has a cascade of %lu\n", r,
+              run.size(), runs[r]->cascade.size());
+      return false;
+    }
+  }
+  return true;
+}
+
+// Check nearest() and above() at `n` random points against a scan of every
+// entry.
+static bool check_lookups(const cw::index::Version &version, u64 n,
+                          std::mt19937_64 &random)
+{
+  for (u64 i = 0; i < n; ++i)
+  {
+    const f64 x = std::ldexp(static_cast<f64>(random() >> 11), -53) * 8;
+    f64 best    = INFINITY;
+    const Entry *least_above = nullptr;
+    for (const auto &level : version.runs)
+      for (const Entry &entry : level->entries)
+      {
+        best = std::min(best, std::abs(entry.norm() - x));
+        if (entry.norm() > x && (!least_above || entry < *least_above))
+          least_above = &entry;
+      }
+
+    const Entry *found = version.nearest(x);
+    if (!found || std::abs(found->norm() - x) != best)
+    {
+      fprintf(stderr, "index: nearest(%f) isn't the nearest entry\n", x);
+      return false;
+    }
+    found = version.above(x);
+    if (found != least_above)
+    {
+      fprintf(stderr, "index: above(%f) isn't the least entry above it\n", x);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(void)
+{
+  std::vector<u64> sizes;
+  for (u64 size = 600; size > 0; --size)
+    sizes.push_back(size);
+  std::mt19937_64 random{2026};
+  for (u64 i = 0; i < 400; ++i)
+    sizes.push_back(1 + (random() % 3000));
+  u64 total = 0;
+  for (u64 size : sizes)
+    total += size;
+
+  std::vector<u64> order(total);
+  for (u64 i = 0; i < total; ++i)
+    order[i] = i;
+  std::shuffle(order.begin(), order.end(), random);
+
+  cw::index::OrderedIndex index;
+  u64 inserted = 0, batches = 0;
+  for (u64 size : sizes)
+  {
+    Run batch;
+    for (u64 i = 0; i < size; ++i)
+      batch.push_back(entry_of(order[inserted + i]));
+    inserted += size;
+    // Nobody else is merging, so this is merged by the time it returns.
+    index.insert(std::move(batch));
+    if (!check_runs(*index.latest(), inserted))
+      return 1;
+    if (++batches % 50 == 0 && !check_lookups(*index.latest(), 5, random))
+      return 1;
+  }
+
+  const auto version = index.latest();
+  if (!check_lookups(*version, 200, random))
+    return 1;
+  printf("index: %lu runs for %lu entries\n", version->runs.size(), total);
+  return 0;
+}
+
+/* Copyright (C) 2026 Aryadev Chavali
+
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License Version 2 for
+ * details.
+
+ * You may distribute and modify this code under the terms of the GNU General
+ * Public License Version 2, which you should have received a copy of along with
+ * this program.  If not, please go to <https://www.gnu.org/licenses/>.
+
+ */
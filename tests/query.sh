@@ -0,0 +1,81 @@
+#!/usr/bin/env sh
+# query.sh: Check the query server's replies to awkward requests
+#
+# Usage: sh tests/query.sh [BINARY]   (default ./cw_tree.out)
+#
+# Requests are built byte by byte (little endian) and piped into
+# `BINARY --serve -`; replies are compared as hex.  Fails if a reply
+# differs, or if anything turns up on stderr (such as a sanitiser's
+# report).  check runs at the end of a pipe, in a subshell, so failures
+# are marked with a file rather than a variable.
+
+BINARY=${1:-./cw_tree.out}
+MARK=$(mktemp)
+rm -f "$MARK"
+
+byte() { printf "\\$(printf %03o $(($1 & 255)))"; }
+
+word() # count value: the low `count` bytes of value
+{
+    n=$2
+    i=0
+    while [ $i -lt $1 ]
+    do
+        byte $n
+        n=$((n >> 8))
+        i=$((i + 1))
+    done
+}
+
+u64() { word 8 $1; }
+
+header() # op count
+{
+    byte $1; byte 0; word 2 0; word 4 $2
+}
+
+check() # name expected-hex, request on stdin
+{
+    errors=$(mktemp)
+    got=$("$BINARY" --serve - 2>"$errors" | od -An -v -tx1 | tr -d ' \n')
+    if [ "$got" != "$2" ] || [ -s "$errors" ]
+    then
+        echo "FAIL $1"
+        echo "  expected $2"
+        echo "  got      $got"
+        sed 's/^/  stderr: /' "$errors"
+        touch "$MARK"
+    else
+        echo "ok   $1"
+    fi
+    rm -f "$errors"
+}
+
+# Replies, as hex
+OK_UNRANK_2=0200000002000000
+OK_RANK_1=0100000001000000
+ZERO=0000000000000000
+ONE=0100000000000000
+BAD_RANGE=0303000000000000
+
+{ header 2 2; u64 -1; u64 0; } |
+    check "unrank ~0 gives 0/0" "$OK_UNRANK_2$ZERO$ZERO$ONE$ONE"
+
+{ header 1 1; u64 1; u64 1; header 3 1; u64 10; u64 0; u64 0; u64 1; u64 1;
+  header 1 1; u64 1; u64 1; } |
+    check "range with 0/0 bound is refused" "$OK_RANK_1$ZERO$BAD_RANGE"
+
+{ header 3 1; u64 10; u64 1; u64 2; u64 2; u64 2; } |
+    check "range with unreduced bound is refused" "$BAD_RANGE"
+
+{ header 3 1; u64 10; u64 1; u64 0; u64 1; u64 1; } |
+    check "range with zero denominator is refused" "$BAD_RANGE"
+
+# All ten of the first ten nodes lie in [1/4, 4/1].
+{ header 3 1; u64 10; u64 1; u64 4; u64 4; u64 1; } |
+    check "range with good bounds" "03000000010000000a00000000000000"
+
+FAILED=0
+[ -e "$MARK" ] && FAILED=1
+rm -f "$MARK"
+exit $FAILED